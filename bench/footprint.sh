@@ -0,0 +1,106 @@
+#!/bin/sh
+#
+# MultiButton Footprint Report
+# Compiles multi_button.c under a matrix of feature flags and reports the
+# .text/.data/.bss of the object and the RAM each button costs, then compares
+# against the checked-in baseline (bench/footprint_baseline.txt).
+#
+# Usage: bench/footprint.sh [-u]
+#   -u  rewrite the baseline from the current tree
+#
+# Environment: CC, SIZE, NM (e.g. CC=arm-none-eabi-gcc SIZE=arm-none-eabi-size
+# NM=arm-none-eabi-nm CFLAGS="-mcpu=cortex-m0 -mthumb") and CFLAGS.
+# Run through:  make footprint
+#
+
+CC=${CC:-gcc}
+SIZE=${SIZE:-size}
+NM=${NM:-nm}
+CFLAGS=${CFLAGS:-}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BASELINE="$ROOT/bench/footprint_baseline.txt"
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# name|flags; each row changes one thing relative to "default" unless noted
+CONFIGS='minimal|-DBUTTON_ENABLE_CALLBACKS=0 -DBUTTON_ENABLE_MULTI_CLICK=0 -DBUTTON_ENABLE_LONG_PRESS=0
+default|
+polling-only|-DBUTTON_ENABLE_CALLBACKS=0
+no-multi-click|-DBUTTON_ENABLE_MULTI_CLICK=0
+no-long-press|-DBUTTON_ENABLE_LONG_PRESS=0
+no-long-hold|-DBUTTON_ENABLE_LONG_HOLD=0
+pool|-DBUTTON_ENABLE_POOL=1
+compact|-DBUTTON_ENABLE_COMPACT=1
+profile|-DBUTTON_ENABLE_PROFILE=1
+stages-1|-DBUTTON_ENABLE_PROFILE=1 -DBUTTON_LONG_STAGE_MAX=1
+fast|-DBUTTON_LAYOUT_FAST=1
+split|-DBUTTON_LAYOUT_SPLIT=1
+split+fast|-DBUTTON_LAYOUT_SPLIT=1 -DBUTTON_LAYOUT_FAST=1
+concurrent|-DBUTTON_ENABLE_CONCURRENT=1
+ring-16|-DBUTTON_EVENT_RING_SIZE=16
+batch-32|-DBUTTON_EVENT_BATCH_SIZE=32
+two-phase|-DBUTTON_ENABLE_TWO_PHASE=1
+budget-scan|-DBUTTON_ENABLE_BUDGET_SCAN=1
+encoder|-DBUTTON_ENABLE_ENCODER=1
+switch|-DBUTTON_ENABLE_SWITCH=1
+logic|-DBUTTON_ENABLE_LOGIC=1
+mmio|-DBUTTON_ENABLE_MMIO=1
+eventfd|-DBUTTON_ENABLE_EVENTFD=1'
+
+# Size of a symbol in the probe object, "-" if absent
+sym_size() {
+    $NM -S -t d "$TMP/probe.o" | awk -v s="$1" '$4 == s { print $2 + 0; found = 1 } END { if (!found) print "-" }'
+}
+
+report() {
+    echo "# MultiButton footprint: $($CC --version | head -n 1)"
+    echo "# flags: -Os $CFLAGS"
+    printf '%-14s %7s %7s %7s %7s %7s\n' config text data bss button slot
+    echo "$CONFIGS" | while IFS='|' read -r name flags; do
+        # shellcheck disable=SC2086
+        if ! $CC -Os $CFLAGS $flags -I"$ROOT" -c "$ROOT/multi_button.c" -o "$TMP/mb.o" 2>/dev/null ||
+           ! $CC -Os $CFLAGS $flags -I"$ROOT" -c "$ROOT/bench/footprint_probe.c" -o "$TMP/probe.o" 2>/dev/null; then
+            printf '%-14s %7s\n' "$name" "n/a"
+            continue
+        fi
+        $SIZE -A "$TMP/mb.o" | awk -v name="$name" -v button="$(sym_size footprint_button)" \
+                                 -v slot="$(sym_size footprint_slot)" '
+            $1 ~ /^\.text/                   { text += $2 }
+            $1 ~ /^\.rodata/                 { text += $2 }
+            $1 ~ /^\.data/                   { data += $2 }
+            $1 ~ /^\.bss/ || $1 == "COMMON"  { bss += $2 }
+            END { printf "%-14s %7d %7d %7d %7s %7s\n", name, text, data, bss, button, slot }'
+    done
+}
+
+if [ "$1" = "-u" ]; then
+    report > "$BASELINE"
+    cat "$BASELINE"
+    echo "Baseline updated: $BASELINE"
+    exit 0
+fi
+
+report > "$TMP/current.txt"
+
+if [ ! -f "$BASELINE" ]; then
+    cat "$TMP/current.txt"
+    echo "No baseline; create one with: bench/footprint.sh -u"
+    exit 0
+fi
+
+if [ "$(head -n 2 "$BASELINE")" != "$(head -n 2 "$TMP/current.txt")" ]; then
+    echo "Note: baseline was recorded with a different compiler or flags:"
+    head -n 2 "$BASELINE"
+fi
+
+# Current values with the change against the baseline in brackets
+awk 'NR == FNR { if ($1 !~ /^#/) for (i = 2; i <= NF; i++) base[$1, i] = $i; next }
+     /^#/ || $1 == "config" { print; next }
+     {
+         line = sprintf("%-14s", $1)
+         for (i = 2; i <= NF; i++) {
+             d = (($1, i) in base && base[$1, i] ~ /^[0-9]+$/ && $i ~ /^[0-9]+$/) ? $i - base[$1, i] : 0
+             line = line sprintf(" %7s", $i) (d ? sprintf(" (%+d)", d) : "")
+         }
+         print line
+     }' "$BASELINE" "$TMP/current.txt"
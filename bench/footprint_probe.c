@@ -0,0 +1,13 @@
+/*
+ * MultiButton Footprint Probe
+ * Never linked or run: bench/footprint.sh compiles it with the same flags as
+ * multi_button.c and reads the symbol sizes below with nm, so the per-button
+ * RAM cost is reported correctly for cross toolchains too.
+ */
+
+#include "multi_button.h"
+
+char footprint_button[sizeof(Button)];
+#if BUTTON_LAYOUT_SPLIT
+char footprint_slot[sizeof(ButtonSlot)];
+#endif
@@ -0,0 +1,208 @@
+/*
+ * MultiButton Library Layout Benchmark
+ * Measures button_ticks() cost for large button populations under the
+ * default layout (linked list / compact table) and the hot/cold split layout,
+ * each with packed bitfields or the unpacked "fast" field layout, plus a
+ * minimal build with callbacks, multi-click and long press compiled out,
+ * the two-phase tick (sample every input, then run every state machine),
+ * and memory-mapped inputs read straight from packed input words.
+ *
+ * Build all variants with:  make bench
+ */
+
+#define _GNU_SOURCE
+#include "multi_button.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#define DEFAULT_BUTTONS  10000
+#define DEFAULT_TICKS    2000
+#define EVICT_BYTES      (32u * 1024u * 1024u)
+
+static uint32_t bench_phase;
+static unsigned char* evict_buf;
+
+// Hardware abstraction layer function: ~1 in 64 button ids pressed at any time
+uint8_t read_button_gpio(uint8_t button_id)
+{
+    return (uint8_t)(((button_id + (bench_phase >> 6)) & 63) == 0);
+}
+
+#if BUTTON_ENABLE_MMIO
+// The same 256 input levels packed one bit per id, as a GPIO input register bank would hold them
+static volatile ButtonInputWord input_words[256 / 32];
+
+static void update_input_words(void)
+{
+    for (int w = 0; w < 256 / 32; w++) {
+        ButtonInputWord word = 0;
+        for (int b = 0; b < 32; b++) {
+            if (read_button_gpio((uint8_t)(w * 32 + b))) word |= (ButtonInputWord)1 << b;
+        }
+        input_words[w] = word;
+    }
+}
+#endif
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Touch a large buffer so each tick starts with a cold cache, as it would in an application
+static void evict_caches(void)
+{
+    for (size_t i = 0; i < EVICT_BYTES; i += 64) evict_buf[i]++;
+}
+
+#ifdef __linux__
+static int perf_open(void)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+static void run(const char* name, int nbuttons, int nticks, int evict)
+{
+    uint64_t misses = 0;
+    double total = 0;
+    int perf_fd = -1;
+
+#ifdef __linux__
+    perf_fd = perf_open();
+#endif
+
+    for (int t = 0; t < nticks; t++) {
+        if (evict) evict_caches();
+        bench_phase++;
+#if BUTTON_ENABLE_MMIO
+        update_input_words();
+#endif
+
+#ifdef __linux__
+        if (perf_fd >= 0) {
+            ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+        double t0 = now_ns();
+        button_ticks();
+        total += now_ns() - t0;
+#ifdef __linux__
+        if (perf_fd >= 0) {
+            uint64_t count = 0;
+            ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(perf_fd, &count, sizeof(count)) == sizeof(count)) misses += count;
+        }
+#endif
+    }
+
+    printf("  %-10s %-5s %8.1f us/tick %7.2f ns/button", name, evict ? "cold" : "warm",
+           total / nticks / 1e3, total / nticks / nbuttons);
+    if (perf_fd >= 0) {
+        printf("  %8.3f cache-misses/button\n", (double)misses / nticks / nbuttons);
+        close(perf_fd);
+    } else {
+        printf("  (cache-miss counter unavailable)\n");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int nbuttons = (argc > 1) ? atoi(argv[1]) : DEFAULT_BUTTONS;
+    int nticks = (argc > 2) ? atoi(argv[2]) : DEFAULT_TICKS;
+
+    if (nbuttons <= 0 || nbuttons > 65535) {
+        fprintf(stderr, "button count must be 1..65535\n");
+        return 1;
+    }
+
+    Button* buttons = calloc((size_t)nbuttons, sizeof(Button));
+    ButtonSlot* slots = calloc((size_t)nbuttons, sizeof(ButtonSlot));
+    evict_buf = malloc(EVICT_BYTES);
+    if (!buttons || !slots || !evict_buf) return 1;
+    memset(evict_buf, 0, EVICT_BYTES);
+
+#if BUTTON_LAYOUT_SPLIT
+    const char* layout = BUTTON_LAYOUT_FAST ? "split+fast" : "split";
+    button_compact(slots, (uint16_t)nbuttons);
+#else
+    const char* layout = BUTTON_LAYOUT_FAST ? "fast" : "default";
+#endif
+
+    printf("Layout: %s, %d buttons, %d ticks, sizeof(Button)=%zu, sizeof(ButtonSlot)=%zu, events=0x%02x\n",
+           layout, nbuttons, nticks, sizeof(Button), sizeof(ButtonSlot), (unsigned)BTN_EVENT_MASK);
+
+    button_init_batch(buttons, (uint16_t)nbuttons, read_button_gpio, 1, 0, NULL);
+
+    // Register in shuffled order so the list is not address-ordered, like buttons added over time
+    int* order = malloc(sizeof(int) * (size_t)nbuttons);
+    if (!order) return 1;
+    for (int i = 0; i < nbuttons; i++) order[i] = i;
+    srand(1);
+    for (int i = nbuttons - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for (int i = 0; i < nbuttons; i++) button_start(&buttons[order[i]]);
+    free(order);
+
+#if !BUTTON_LAYOUT_SPLIT
+    run("list", nbuttons, nticks, 0);
+    run("list", nbuttons, nticks / 10, 1);
+    button_compact(slots, (uint16_t)nbuttons);
+#endif
+    run("table", nbuttons, nticks, 0);
+    run("table", nbuttons, nticks / 10, 1);
+
+#if BUTTON_ENABLE_TWO_PHASE
+    // Same table, all inputs sampled into a level buffer before any state machine runs
+    uint8_t* levels = malloc((size_t)nbuttons);
+    if (!levels) return 1;
+    button_set_sampler(levels, (uint16_t)nbuttons, NULL);
+    run("2-phase", nbuttons, nticks, 0);
+    run("2-phase", nbuttons, nticks / 10, 1);
+    button_set_sampler(NULL, 0, NULL);
+    free(levels);
+#endif
+
+#if BUTTON_ENABLE_MMIO
+    // Same population rebound to the packed input words: sorted table, 32 buttons per word
+    button_stop_batch(buttons, (uint16_t)nbuttons);
+    for (int i = 0; i < nbuttons; i++) {
+        uint8_t id = (uint8_t)i;
+        button_init_mmio(&buttons[i], &input_words[id / 32], (ButtonInputWord)1 << (id % 32), 1, id);
+    }
+    button_start_batch(buttons, (uint16_t)nbuttons);
+    button_compact(slots, (uint16_t)nbuttons);
+    run("mmio", nbuttons, nticks, 0);
+    run("mmio", nbuttons, nticks / 10, 1);
+#endif
+
+    free(evict_buf);
+    free(slots);
+    free(buttons);
+    return 0;
+}
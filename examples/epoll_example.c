@@ -0,0 +1,139 @@
+/*
+ * MultiButton Library epoll Example
+ * This example demonstrates eventfd-based notification: a timer thread runs
+ * button_ticks(), the consumer thread sleeps in epoll_wait() until events exist.
+ *
+ * Requires the library to be built with BUTTON_ENABLE_EVENTFD=1 (Linux only).
+ */
+
+#define _DEFAULT_SOURCE
+#include "multi_button.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+
+#define MAX_BUTTONS 2
+#define BATCH_SIZE  16
+
+// Button instances
+static Button buttons[MAX_BUTTONS];
+static volatile int running = 1;
+static volatile uint8_t button_states[MAX_BUTTONS];
+
+// Hardware abstraction layer function
+uint8_t read_button_gpio(uint8_t button_id)
+{
+    return (button_id < MAX_BUTTONS) ? button_states[button_id] : 0;
+}
+
+// Timer thread: 5ms ticks plus a scripted press pattern
+void* tick_thread(void* arg)
+{
+    (void)arg;
+
+    // Each step: button, level, duration in ticks
+    static const struct { int id; int level; int ticks; } script[] = {
+        {0, 1, 20}, {0, 0, 100},                            // single click
+        {1, 1, 16}, {1, 0, 10}, {1, 1, 16}, {1, 0, 100},    // double click
+        {0, 1, 260}, {0, 0, 100},                           // long press
+    };
+
+    for (size_t i = 0; i < sizeof(script) / sizeof(script[0]); i++) {
+        button_states[script[i].id] = (uint8_t)script[i].level;
+        for (int t = 0; t < script[i].ticks; t++) {
+            button_ticks();
+            usleep(TICKS_INTERVAL * 1000);
+        }
+    }
+
+    running = 0;
+    return NULL;
+}
+
+static const char* event_name(uint8_t event)
+{
+    static const char* names[] = {
+        "Press Down", "Press Up", "Press Repeat", "Single Click",
+        "Double Click", "Long Press Start", "Long Press Hold", "Long Press Stage"
+    };
+    return (event < BTN_EVENT_COUNT) ? names[event] : "Unknown";
+}
+
+// Main function
+int main(void)
+{
+    ButtonEventRecord batch[BATCH_SIZE];
+    struct epoll_event ev;
+    pthread_t thread;
+    int wakeups = 0;
+    int hold_events = 0;
+
+    printf("🚀 MultiButton Library epoll Example\n");
+    printf("=====================================\n\n");
+
+    for (int i = 0; i < MAX_BUTTONS; i++) {
+        button_init(&buttons[i], read_button_gpio, 1, (uint8_t)i);
+        button_start(&buttons[i]);
+    }
+
+    int efd = button_eventfd_open();
+    int epfd = epoll_create1(0);
+    if (efd < 0 || epfd < 0) {
+        perror("eventfd/epoll");
+        return 1;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.fd = efd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, efd, &ev);
+
+    pthread_create(&thread, NULL, tick_thread, NULL);
+
+    // Consumer loop: sleep until the library signals new events
+    while (running) {
+        if (epoll_wait(epfd, &ev, 1, 100) <= 0) continue;
+        wakeups++;
+
+        int n;
+        do {
+            n = button_eventfd_drain(batch, BATCH_SIZE);
+            for (int i = 0; i < n; i++) {
+                if (batch[i].event == BTN_LONG_PRESS_HOLD) {
+                    hold_events++;   // too chatty to print
+                    continue;
+                }
+                printf("📡 [tick %5u] Button %d: %s", (unsigned)batch[i].tick,
+                       batch[i].button->button_id, event_name(batch[i].event));
+                if (batch[i].event == BTN_PRESS_UP || batch[i].event == BTN_PRESS_REPEAT) {
+                    printf(" (%u ms)", (unsigned)(batch[i].duration * TICKS_INTERVAL));
+                }
+                printf("\n");
+            }
+        } while (n == BATCH_SIZE);
+    }
+
+    pthread_join(thread, NULL);
+
+    printf("\n📊 %d wakeups, %d long-hold events, %u dropped\n",
+           wakeups, hold_events, (unsigned)button_event_dropped());
+
+    close(epfd);
+    button_eventfd_close();
+    for (int i = 0; i < MAX_BUTTONS; i++) {
+        button_stop(&buttons[i]);
+    }
+
+    printf("✅ epoll example finished!\n");
+    return 0;
+}
+
+/*
+ * Build and run instructions:
+ *
+ * Build:
+ * make epoll_example
+ *
+ * Run:
+ * ./build/bin/epoll_example
+ */
@@ -3,29 +3,383 @@
  * All rights reserved
  */
 
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE     // eventfd()/read()/write() 在 -std=c99 下需要显式打开 POSIX 声明
+#endif
+
 #include "multi_button.h"
 
+#if BUTTON_ENABLE_COMPACT
+#include <stdlib.h>
+#endif
+
+#if BUTTON_ENABLE_EVENTFD
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+/*
+ * 原子访问辅助宏：事件缓冲区的生产者（button_ticks() 所在线程）与消费者可能位于不同线程/中断。
+ * GCC/Clang 使用 __atomic 内建函数；其他编译器（单核 MCU）退化为 volatile 访问。
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define BTN_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define BTN_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define BTN_LOAD_SEQ(p)          __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define BTN_STORE_SEQ(p, v)      __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define BTN_EXCHANGE_SEQ(p, v)   __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#define BTN_CAS_WEAK(p, e, v)    __atomic_compare_exchange_n((p), (e), (v), 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#define BTN_FETCH_SUB_SEQ(p, v)  __atomic_fetch_sub((p), (v), __ATOMIC_SEQ_CST)
+#define BTN_FENCE_ACQUIRE()      __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define BTN_PREFETCH(p)          __builtin_prefetch(p)
+#else
+#define BTN_LOAD_ACQUIRE(p)      (*(p))
+#define BTN_STORE_RELEASE(p, v)  (*(p) = (v))
+#define BTN_LOAD_SEQ(p)          BTN_LOAD_ACQUIRE(p)
+#define BTN_STORE_SEQ(p, v)      BTN_STORE_RELEASE(p, v)
+#define BTN_FENCE_ACQUIRE()      ((void)0)
+#define BTN_PREFETCH(p)          ((void)0)
+#if BUTTON_ENABLE_CONCURRENT
+#error "BUTTON_ENABLE_CONCURRENT requires GCC/Clang atomic builtins"
+#endif
+#endif
+
+// 配置读写（回调槽位、启动/停止请求）：并发模式下为原子访问，否则为普通访问
+#if BUTTON_ENABLE_CONCURRENT
+#define BTN_CFG_LOAD(p)          BTN_LOAD_ACQUIRE(p)
+#define BTN_CFG_STORE(p, v)      BTN_STORE_SEQ(p, v)
+#else
+#define BTN_CFG_LOAD(p)          (*(p))
+#define BTN_CFG_STORE(p, v)      (*(p) = (v))
+#endif
+
+// 状态字段读取（getter）：快速布局下字段为整字节，可用 relaxed 原子读跨线程查询；位域无法取地址，只能普通读取
+#if BUTTON_LAYOUT_FAST && (defined(__GNUC__) || defined(__clang__))
+#define BTN_FIELD_LOAD(hot, f)   __atomic_load_n(&(hot)->f, __ATOMIC_RELAXED)
+#else
+#define BTN_FIELD_LOAD(hot, f)   ((hot)->f)
+#endif
+
 /**
  * @brief 执行按键事件对应的回调函数
  *
  * @param ev 事件类型（如 BTN_PRESS_DOWN、BTN_SINGLE_CLICK 等）
  *
  * @note
- * - 回调函数数组 `handle->cb[]` 中，每个索引对应一个具体事件；
+ * - 回调函数数组 `handle->cb[]` 中，每个已编译的事件对应一个槽位（BTN_CB_SLOT(ev)，编译期常量）；
  * - 如果对应事件的回调函数非空（即已注册），则调用它并传入当前按键结构体指针 `handle`；
+ * - 关闭 BUTTON_ENABLE_CALLBACKS 时只保留事件发布，应用通过 button_get_event() 轮询；
  * - 使用 `do { ... } while(0)` 包裹，确保宏展开在多语句结构中行为一致，避免语法问题。
  *
  * @example
  * EVENT_CB(BTN_SINGLE_CLICK); // 如果注册了单击事件的回调函数，则执行它
  */
-#define EVENT_CB(ev)   do { if(handle->cb[ev]) handle->cb[ev](handle); } while(0)
+#if BUTTON_ENABLE_CALLBACKS
+#define EVENT_CB(ev)   do { Button* owner_ = BTN_OWNER(hot); BtnCallback cb_ = BTN_CFG_LOAD(&owner_->cb[BTN_CB_SLOT(ev)]); \
+                            EVENT_PUBLISH(ev); if(cb_) cb_(owner_); } while(0)
+#else
+#define EVENT_CB(ev)   EVENT_PUBLISH(ev)
+#endif
+
+/*
+ * 热数据访问：默认布局下状态字段就在 Button 内；分离布局下位于遍历表项 ButtonSlot 内。
+ * button_handler() 只通过 ButtonHot 访问状态字段，只有产生事件时才通过 BTN_OWNER() 访问冷数据。
+ */
+#if BUTTON_LAYOUT_SPLIT
+typedef ButtonSlot ButtonHot;
+#define BTN_HOT(handle)     ((handle)->slot)
+#define BTN_OWNER(hot)      ((hot)->handle)
+#define BTN_SLOT_HOT(slot)  (slot)
+#else
+typedef Button ButtonHot;
+#define BTN_HOT(handle)     (handle)
+#define BTN_OWNER(hot)      (hot)
+#define BTN_SLOT_HOT(slot)  ((slot)->handle)
+#endif
+
+// 当前状态已持续的节拍数（无符号减法，全局节拍回绕时结果仍然正确）
+#define BTN_ELAPSED(hot, now)   ((uint32_t)((now) - (hot)->state_tick))
+
+// 记录随 BTN_PRESS_UP/BTN_PRESS_REPEAT 交付的时长（状态起点到当前节拍），只在产生这两个事件时写冷数据
+#define BTN_RECORD_DURATION(hot, now)  (BTN_OWNER(hot)->duration = BTN_ELAPSED(hot, now))
+
+#if BUTTON_ENABLE_CALLBACKS
+/*
+ * 运行期事件（变量）到回调槽位的映射。BTN_CB_SLOT() 对常量事件在编译期求值，对变量事件会展开成按位计数，
+ * 因此 button_attach() 等按变量事件访问回调数组时查常量表；BTN_CB_NONE 表示事件被裁剪。
+ * 全部事件都编译时映射为恒等，不查表（表被优化掉）。
+ */
+#define BTN_CB_NONE             0xffu
+#define BTN_CB_ENTRY(ev)        ((BTN_EVENT_MASK & (1u << (ev))) ? BTN_CB_SLOT(ev) : BTN_CB_NONE)
+
+static const uint8_t cb_slot_map[BTN_EVENT_COUNT] = {   // 按 ButtonEvent 顺序
+    BTN_CB_ENTRY(BTN_PRESS_DOWN),       BTN_CB_ENTRY(BTN_PRESS_UP),
+    BTN_CB_ENTRY(BTN_PRESS_REPEAT),     BTN_CB_ENTRY(BTN_SINGLE_CLICK),
+    BTN_CB_ENTRY(BTN_DOUBLE_CLICK),     BTN_CB_ENTRY(BTN_LONG_PRESS_START),
+    BTN_CB_ENTRY(BTN_LONG_PRESS_HOLD),  BTN_CB_ENTRY(BTN_LONG_PRESS_STAGE)
+};
+
+/**
+  * @brief  事件对应的回调槽位（事件为变量时使用）
+  * @param  ev: 事件（调用者保证小于 BTN_EVENT_COUNT）
+  * @retval 槽位；BTN_CB_NONE: 事件被裁剪
+  */
+static inline unsigned button_cb_slot(unsigned ev)
+{
+    return BTN_CB_COUNT == BTN_EVENT_COUNT ? ev : cb_slot_map[ev];
+}
+#endif
+
+// 重复按下次数：关闭连击识别时每次点击序列只有一次按下，有事件即为 1
+#if BUTTON_ENABLE_MULTI_CLICK
+#define BTN_REPEAT(hot)         BTN_FIELD_LOAD(hot, repeat)
+#else
+#define BTN_REPEAT(hot)         ((uint8_t)(BTN_FIELD_LOAD(hot, event) != BTN_NONE_PRESS))
+#endif
+
+// 按键的时序配置（位于冷数据中，状态机只在按键非空闲时读取）；关闭时序配置时为编译期常量
+#if BUTTON_ENABLE_PROFILE
+#define BTN_PROFILE(hot)        button_profile(BTN_OWNER(hot))
+#else
+#define BTN_PROFILE(hot)        (&default_profile)
+#endif
+
+// 配置中的时间窗口，0 表示沿用 SHORT_TICKS
+#define BTN_WINDOW(profile, field)  button_window((profile)->field)
+
+#if BUTTON_EVENT_RING_SIZE
+#define EVENT_RING_PUBLISH(ev)  button_event_publish(hot, ev)
+#else
+#define EVENT_RING_PUBLISH(ev)  ((void)0)
+#endif
+
+#if BUTTON_EVENT_BATCH_SIZE
+#define EVENT_BATCH_APPEND(ev)  button_batch_append(hot, ev)
+#else
+#define EVENT_BATCH_APPEND(ev)  ((void)0)
+#endif
+
+#define EVENT_PUBLISH(ev)   do { EVENT_RING_PUBLISH(ev); EVENT_BATCH_APPEND(ev); } while (0)
 
 // Button handle list head
 static Button* head_handle = NULL;
 
+// 全局节拍计数，每次 button_ticks() 加 1
+static uint32_t tick_count = 0;
+
+// 默认时序配置：单级长按（阈值 LONG_TICKS），双击窗口与连击按下上限均为 SHORT_TICKS
+static const ButtonProfile default_profile = { { LONG_TICKS }, 1, SHORT_TICKS, SHORT_TICKS };
+
+#if BUTTON_EVENT_RING_SIZE
+/*
+ * 单生产者、多消费者事件环形缓冲区（Disruptor 风格）：
+ * - 生产者为 button_ticks()，只写 ring_head（单调递增的序号），从不等待消费者，
+ *   因此发布开销与订阅者数量无关；
+ * - 每个订阅者（ButtonSubscriber）持有自己的读游标，直接在缓冲区内读取记录，不做逐条复制；
+ * - 订阅者落后超过容量时跳过被覆盖的记录并累加 overruns；
+ * - 记录先写入槽位，再发布 ring_head。
+ *
+ * 生产者可能与读取同时运行时（并发模式、eventfd 跨线程消费），落后恰好 BUTTON_EVENT_RING_SIZE 条的最旧记录
+ * 可能正被写入下一条记录，只能视为已覆盖，因此可用容量为 BUTTON_EVENT_RING_SIZE - 1；
+ * 否则（读取与 button_ticks() 在同一上下文）全部容量可用。peek 与 commit 使用同一界限。
+ */
+#if BUTTON_ENABLE_CONCURRENT || BUTTON_ENABLE_EVENTFD
+#define BTN_RING_USABLE         (BUTTON_EVENT_RING_SIZE - 1)
+#else
+#define BTN_RING_USABLE         BUTTON_EVENT_RING_SIZE
+#endif
+
+static ButtonEventRecord ring_buf[BUTTON_EVENT_RING_SIZE];
+static uint32_t ring_head = 0;          // 生产者序号（下一条记录的位置）
+static ButtonSubscriber default_sub;    // button_event_read() 使用的内置订阅者
+
+static void button_event_publish(ButtonHot* hot, ButtonEvent ev);
+#endif
+
+#if BUTTON_EVENT_BATCH_SIZE
+/*
+ * 批量事件交付：事件在节拍内追加到 batch_buf，遍历结束（仍处于遍历状态，回调中的启动/停止规则同样适用）
+ * 时整批交给 batch_sink，每节拍一次间接调用，而不是每个事件一次。
+ */
+static ButtonEventRecord batch_buf[BUTTON_EVENT_BATCH_SIZE];
+static int batch_count = 0;             // 本批已追加的记录数
+static ButtonBatchSink batch_sink = NULL;
+
+static void button_batch_append(ButtonHot* hot, ButtonEvent ev);
+static void button_batch_flush(void);
+#endif
+
+#if BUTTON_EVENT_RING_SIZE || BUTTON_EVENT_BATCH_SIZE
+static inline void button_event_fill(ButtonEventRecord* rec, ButtonHot* hot, ButtonEvent ev);
+#endif
+
+/*
+ * 待应用的启动/停止请求（侵入式链表，无需额外内存）：
+ * - 回调函数在 button_ticks() 遍历期间调用 button_start()/button_stop() 时，只登记请求，
+ *   遍历结束后统一应用，保证遍历过程中链表结构不变；
+ * - 并发模式下任意线程的请求都走这条路径，链表为无锁 MPSC 栈，工作链表只由节拍线程修改。
+ */
+enum {
+    BTN_OP_NONE = 0,
+    BTN_OP_START,
+    BTN_OP_STOP,
+    BTN_OP_START_SLOT       // 启动请求，登记时已预留遍历表项（仅分离布局）
+};
+
+static Button* pending_head = NULL;
+#if !BUTTON_ENABLE_CONCURRENT
+static uint8_t dispatching = 0;     // button_ticks() 正在遍历工作链表
+#endif
+
+static void button_request(Button* handle, uint8_t op);
+static void button_apply_pending(void);
+static int  button_link(Button* handle);
+static void button_unlink(Button* handle);
+
+#if BUTTON_ENABLE_COMPACT
+/*
+ * 连续遍历表：button_compact() 设置后，button_ticks() 按数组顺序扫描，链表仅用于登记。
+ * 表项按 (HAL 函数, button_id) 排序，同一 HAL 函数的调用相邻，间接跳转容易预测；
+ * button_link()/button_unlink() 保持数组同步，容量不足时自动退回链表遍历。
+ */
+#define BTN_PREFETCH_DISTANCE   4   // 扫描时提前预取的表项数
+
+#if BUTTON_LAYOUT_SPLIT && BUTTON_SPLIT_DEFAULT_SLOTS
+// 分离布局：调用 button_compact() 之前热数据存放在内置遍历表中，之后随表项复制到调用者的数组
+static ButtonSlot split_slots[BUTTON_SPLIT_DEFAULT_SLOTS];
+static ButtonSlot* slot_table = split_slots;
+static uint16_t slot_count = 0;
+static uint16_t slot_capacity = BUTTON_SPLIT_DEFAULT_SLOTS;
+#else
+static ButtonSlot* slot_table = NULL;   // 遍历表，NULL 表示使用链表遍历
+static uint16_t slot_count = 0;         // 表项数
+static uint16_t slot_capacity = 0;      // 表容量
+#endif
+
+static int  button_slot_insert(Button* handle);
+static void button_slot_remove(Button* handle);
+static void button_slot_fill(ButtonSlot* slot, Button* handle);
+#if BUTTON_LAYOUT_SPLIT
+/*
+ * 推迟的启动请求在登记时预留表项（slot_reserved 计数），button_start() 在表满时与直接调用一样返回 -3，
+ * 请求应用时一定能插入；请求被停止请求覆盖或应用后释放预留。
+ */
+static uint16_t slot_reserved = 0;      // 已登记、尚未应用的启动请求预留的表项数
+
+static void button_slot_relink(ButtonSlot* slots, uint16_t from, uint16_t to);
+static int  button_slot_reserve(void);
+static void button_slot_unreserve(void);
+#endif
+#endif
+
+#if BUTTON_ENABLE_TWO_PHASE
+/*
+ * 两阶段节拍：第一阶段把遍历表中所有按键的电平读入 sample_levels（与表项一一对应），
+ * 第二阶段再依次运行状态机，本节拍内的状态机都基于同一份快照。
+ */
+static uint8_t* sample_levels = NULL;   // 采样缓冲区，NULL 表示逐个读取
+static uint16_t sample_capacity = 0;    // 缓冲区容量，小于表项数时退回逐个读取
+static ButtonSampler sample_fn = NULL;  // 用户采样函数，NULL 表示逐个调用 HAL 函数
+
+static void button_sample_levels(uint8_t* levels, const ButtonSlot* slots, uint16_t count);
+#endif
+
+#if BUTTON_ENABLE_BUDGET_SCAN
+/*
+ * 限时增量扫描：button_ticks_budget() 从游标处继续服务，到达工作集末尾即完成一轮。
+ * 遍历表模式下游标就是表项下标；链表模式下缓存下一个节点，工作集结构变化后按已服务个数从表头重新定位。
+ */
+static uint16_t scan_pos = 0;           // 本轮已服务的按键数（遍历表模式下即下一个表项下标）
+static uint8_t  scan_in_round = 0;      // 一轮扫描正在进行
+static uint32_t scan_round_start;       // 本轮第一次服务时的节拍
+static uint32_t scan_topology = 0;      // 工作集结构变更计数
+#if !BUTTON_LAYOUT_SPLIT
+static Button*  scan_next = NULL;       // 链表模式下本轮的下一个节点
+static uint32_t scan_next_topology;     // scan_next 记录时的结构变更计数
+#endif
+static ButtonScanStats scan_stats;
+
+#define BTN_SCAN_INVALIDATE()   (scan_topology++)
+#else
+#define BTN_SCAN_INVALIDATE()   ((void)0)
+#endif
+
+#if BUTTON_ENABLE_ENCODER
+static ButtonEncoder* encoder_head = NULL;  // 编码器链表
+
+static void button_encoder_scan(void);
+
+/* 读取编码器当前相位，A 为高位 */
+static inline uint8_t button_encoder_phase(const ButtonEncoder* encoder)
+{
+    return (uint8_t)((encoder->hal_level(encoder->a_id) ? 2 : 0) |
+                     (encoder->hal_level(encoder->b_id) ? 1 : 0));
+}
+#endif
+
+#if BUTTON_ENABLE_SWITCH
+static ButtonSwitch* switch_head = NULL;    // 开关链表
+
+static void button_switch_scan(void);
+#endif
+
+#if BUTTON_ENABLE_TWO_PHASE && (BUTTON_ENABLE_ENCODER || BUTTON_ENABLE_SWITCH)
+/*
+ * 编码器和开关同样纳入两阶段快照：采样阶段把相位/电平存入各自的 sample 字段，本节拍随后的扫描直接使用。
+ * 未取快照的节拍（未设置遍历表或采样缓冲区、限时增量扫描）仍在扫描时读取。
+ */
+#define BTN_HAS_AUX_SAMPLE  1
+
+static uint8_t aux_sampled = 0;         // 本节拍的编码器/开关快照已读取
+
+static void button_aux_sample(void);
+#else
+#define BTN_HAS_AUX_SAMPLE  0
+#endif
+
+#if BUTTON_ENABLE_LOGIC
+/*
+ * 逻辑按键：物理输入在节拍内第一次被某个逻辑按键读取时整体采样一次，结果按位缓存在 logic_state 中，
+ * 同一节拍内其余逻辑按键只对缓存求值。
+ */
+static const ButtonInput* logic_inputs = NULL;  // 物理输入表
+static const ButtonLogic* logic_exprs = NULL;   // 逻辑表达式表
+static uint8_t  logic_input_count = 0;          // 物理输入数
+static uint8_t  logic_expr_count = 0;           // 表达式数
+static uint32_t logic_state;                    // 本节拍的输入快照，位为 1 表示有效
+static uint32_t logic_tick;                     // logic_state 采样时的节拍
+#endif
+
+#if BUTTON_ENABLE_MMIO
+/*
+ * 内存映射输入：按键扫描顺序中相邻且位于同一输入字的按键共用一次加载（遍历表按输入字排序，同一字的按键总是相邻）。
+ * 缓存在每个节拍开始时清空，因此每个字每节拍至少重新加载一次。
+ */
+static const volatile ButtonInputWord* mmio_reg;   // 本节拍最近一次加载的输入字
+static ButtonInputWord mmio_word;                  // 该字的值
+
+static uint8_t button_mmio_hal(uint8_t button_id);
+#endif
+
+#if BUTTON_ENABLE_EVENTFD
+static int event_fd = -1;           // eventfd 描述符，-1 表示未打开
+static uint32_t event_fd_pending;   // 已通知但消费者尚未取走，用于合并写操作
+static uint32_t tick_ring_head;     // 本节拍开始时的环形缓冲区写位置
+#endif
+
 // Forward declarations
-static void button_handler(Button* handle);
+static void button_handler(ButtonHot* hot, uint8_t read_gpio_level);
+#if BUTTON_ENABLE_PROFILE
+static inline const ButtonProfile* button_profile(Button* handle);
+#endif
+static inline uint32_t button_window(uint32_t ticks);
+#if !BUTTON_LAYOUT_SPLIT
 static inline uint8_t button_read_level(Button* handle);
+#endif
+#if BUTTON_ENABLE_COMPACT
+static inline uint8_t button_slot_level(const ButtonSlot* slot);
+#endif
 
 /**
   * @brief  Initialize the button struct handle
@@ -40,14 +394,67 @@ void button_init(Button* handle, uint8_t(*pin_level)(uint8_t), uint8_t active_le
 	if (!handle || !pin_level) return;  // parameter validation 检查传入的参数是否合法，如果句柄或GPIO读取函数为空，则直接返回
 	
 	memset(handle, 0, sizeof(Button));  	 //清零按键结构体，初始化为0，防止未初始化的字段产生问题
-	handle->event = (uint8_t)BTN_NONE_PRESS; // 设置事件为BTN_NONE_PRESS，表示当前没有事件发生
 	handle->hal_button_level = pin_level;    // 保存HAL GPIO读取函数，用于读取按钮的当前电平状态
-	handle->button_level = !active_level;    // 将当前按钮电平设置为活动电平的反值，初始化为按键未按下状态（GPIO电平可能是高电平或低电平）
 	handle->active_level = active_level;     // 保存按键活动电平，表示按下时GPIO电平的状态
 	handle->button_id = button_id;           // 保存按钮的唯一标识符，用于区分不同的按钮
+#if !BUTTON_LAYOUT_SPLIT
+	handle->event = (uint8_t)BTN_NONE_PRESS; // 设置事件为BTN_NONE_PRESS，表示当前没有事件发生
+	handle->button_level = !active_level;    // 将当前按钮电平设置为活动电平的反值，初始化为按键未按下状态（GPIO电平可能是高电平或低电平）
 	handle->state = BTN_STATE_IDLE;          // 初始化状态机为BTN_STATE_IDLE状态，表示按键处于空闲状态，未被按下
+#endif
+	// 分离布局下状态字段在 button_start() 分配遍历表项时初始化
+}
+
+#if BUTTON_ENABLE_MMIO
+/**
+  * @brief  初始化绑定到内存映射输入的按键
+  * @param  handle: 按键结构体
+  * @param  reg: 输入字地址（GPIO 输入数据寄存器、DMA 缓冲区或变量）
+  * @param  mask: 属于本按键的位，(*reg & mask) 非 0 即为电平 1
+  * @param  active_level: 按下时的电平（极性）
+  * @param  button_id: 按键标识符
+  * @retval None
+  *
+  * @note 扫描时直接加载输入字，不调用 HAL 函数；同一输入字上的多个按键每节拍只加载一次。
+  *       用户的两阶段采样函数需自行处理 input_reg 非 NULL 的表项
+  */
+void button_init_mmio(Button* handle, const volatile ButtonInputWord* reg, ButtonInputWord mask,
+                      uint8_t active_level, uint8_t button_id)
+{
+    if (!handle || !reg || !mask) return;
+
+    // HAL 指针保持非空（占位函数），"已初始化"判断和遍历表排序无需区分两种按键
+    button_init(handle, button_mmio_hal, active_level, button_id);
+    handle->input_reg = reg;
+    handle->input_mask = mask;
+}
+
+/**
+  * @brief  内存映射按键的占位 HAL 函数，扫描时不会被调用
+  */
+static uint8_t button_mmio_hal(uint8_t button_id)
+{
+    (void)button_id;
+    return 0;
+}
+
+/**
+  * @brief  读取内存映射输入位：与上一次加载的是同一个字时复用已加载的值
+  * @param  reg: 输入字地址
+  * @param  mask: 位掩码
+  * @retval 电平（0 或 1）
+  */
+static inline uint8_t button_mmio_level(const volatile ButtonInputWord* reg, ButtonInputWord mask)
+{
+    if (reg != mmio_reg) {
+        mmio_reg = reg;
+        mmio_word = *reg;
+    }
+    return (mmio_word & mask) ? 1 : 0;
 }
+#endif
 
+#if BUTTON_ENABLE_CALLBACKS
 /**
   * @brief  注册（绑定）指定事件的回调函数
   * @param  handle: 按键句柄结构体指针
@@ -57,11 +464,15 @@ void button_init(Button* handle, uint8_t(*pin_level)(uint8_t), uint8_t active_le
   */
 void button_attach(Button* handle, ButtonEvent event, BtnCallback cb)
 {
-    // 参数校验：确保按键句柄非空，事件编号合法
+    unsigned slot;
+
+    // 参数校验：确保按键句柄非空，事件编号合法且未被裁剪
     if (!handle || event >= BTN_EVENT_COUNT) return;
+    slot = button_cb_slot(event);
+    if (slot == BTN_CB_NONE) return;
 
-    // 将回调函数赋值到事件对应的数组元素中
-    handle->cb[event] = cb;
+    // 将回调函数赋值到事件对应的数组元素中（并发模式下为原子写）
+    BTN_CFG_STORE(&handle->cb[slot], cb);
 }
 
 /**
@@ -72,12 +483,17 @@ void button_attach(Button* handle, ButtonEvent event, BtnCallback cb)
   */
 void button_detach(Button* handle, ButtonEvent event)
 {
-    // 参数校验：确保按键句柄非空，事件编号合法
+    unsigned slot;
+
+    // 参数校验：确保按键句柄非空，事件编号合法且未被裁剪
     if (!handle || event >= BTN_EVENT_COUNT) return;
+    slot = button_cb_slot(event);
+    if (slot == BTN_CB_NONE) return;
 
     // 将事件回调清空，表示不再处理此事件
-    handle->cb[event] = NULL;
+    BTN_CFG_STORE(&handle->cb[slot], (BtnCallback)NULL);
 }
+#endif
 
 
 /**
@@ -87,26 +503,26 @@ void button_detach(Button* handle, ButtonEvent event)
   */
 ButtonEvent button_get_event(Button* handle)
 {
-    // 参数校验：如果按键句柄为空，返回未按下事件
-    if (!handle) return BTN_NONE_PRESS;
+    // 参数校验：如果按键句柄为空（或分离布局下按键未启动），返回未按下事件
+    if (!handle || !BTN_HOT(handle)) return BTN_NONE_PRESS;
 
     // 返回当前按键的事件类型
-    return (ButtonEvent)(handle->event);
+    return (ButtonEvent)BTN_FIELD_LOAD(BTN_HOT(handle), event);
 }
 
 
 /**
   * @brief  获取按键的重复按下次数
   * @param  handle: 按键句柄结构体指针
-  * @retval 重复按下次数
+  * @retval 重复按下次数（关闭连击识别时，有事件为 1，否则为 0）
   */
 uint8_t button_get_repeat_count(Button* handle)
 {
     // 参数校验：如果按键句柄为空，返回 0（没有按下）
-    if (!handle) return 0;
+    if (!handle || !BTN_HOT(handle)) return 0;
 
     // 返回当前按键的重复按下次数
-    return handle->repeat;
+    return BTN_REPEAT(BTN_HOT(handle));
 }
 
 /**
@@ -116,17 +532,24 @@ uint8_t button_get_repeat_count(Button* handle)
   */
 void button_reset(Button* handle)
 {
+    ButtonHot* hot;
+
     // 参数校验：如果按键句柄为空，直接返回
-    if (!handle) return;
+    if (!handle || !(hot = BTN_HOT(handle))) return;
 
     // 将按键状态重置为空闲状态
-    handle->state = BTN_STATE_IDLE;
+    hot->state = BTN_STATE_IDLE;
 
     // 重置计时器和事件相关变量
-    handle->ticks = 0;                   // 重置 ticks 计数器
-    handle->repeat = 0;                  // 重置重复计数器
-    handle->event = (uint8_t)BTN_NONE_PRESS;  // 清空当前事件标识
-    handle->debounce_cnt = 0;            // 清空去抖动计数器
+    hot->state_tick = tick_count;        // 以当前节拍作为状态起点
+#if BUTTON_ENABLE_MULTI_CLICK
+    hot->repeat = 0;                     // 重置重复计数器
+#endif
+    hot->event = (uint8_t)BTN_NONE_PRESS;     // 清空当前事件标识
+    hot->debounce_cnt = 0;               // 清空去抖动计数器
+#if BUTTON_ENABLE_LONG_PRESS
+    hot->long_stage = 0;                 // 清空长按级数
+#endif
 }
 
 
@@ -139,9 +562,119 @@ int button_is_pressed(Button* handle)
 {
     // 参数校验：如果按键句柄为空，返回 -1 表示错误
     if (!handle) return -1;
+    if (!BTN_HOT(handle)) return 0;  // 分离布局下未启动的按键视为未按下
 
     // 判断按键电平是否为活动电平，如果是则表示按键被按下
-    return (handle->button_level == handle->active_level) ? 1 : 0;
+    return (BTN_FIELD_LOAD(BTN_HOT(handle), button_level) == BTN_HOT(handle)->active_level) ? 1 : 0;
+}
+
+
+/**
+  * @brief  获取全局节拍计数
+  * @param  None
+  * @retval button_ticks() 的累计调用次数
+  */
+uint32_t button_get_tick(void)
+{
+    return tick_count;
+}
+
+#if BUTTON_ENABLE_PROFILE
+/**
+  * @brief  设置按键的时序配置（多级长按阈值等）
+  * @param  handle: 按键句柄结构体指针
+  * @param  profile: 时序配置，NULL 恢复默认配置；配置由调用者分配，使用期间必须保持有效
+  * @retval 0: 成功，-2: 参数无效（级数越界或阈值未严格递增）
+  */
+int button_set_profile(Button* handle, const ButtonProfile* profile)
+{
+    if (!handle) return -2;
+
+    if (profile) {
+        if (profile->long_stages < 1 || profile->long_stages > BUTTON_LONG_STAGE_MAX) return -2;
+        for (uint8_t i = 1; i < profile->long_stages; i++) {
+            if (profile->long_ticks[i] <= profile->long_ticks[i - 1]) return -2;
+        }
+    }
+
+    BTN_CFG_STORE(&handle->profile, profile);
+    return 0;
+}
+#endif
+
+/**
+  * @brief  获取按键当前已按住的时长
+  * @param  handle: 按键句柄结构体指针
+  * @retval 自本次按下以来的节拍数，未按下时为 0
+  */
+uint32_t button_get_hold_ticks(Button* handle)
+{
+    ButtonHot* hot;
+
+    if (!handle || !(hot = BTN_HOT(handle))) return 0;
+
+    switch (BTN_FIELD_LOAD(hot, state)) {
+    case BTN_STATE_PRESS:
+    case BTN_STATE_REPEAT:
+    case BTN_STATE_LONG_HOLD:
+        return BTN_ELAPSED(hot, tick_count);  // 按下状态的起点即本次按下的节拍
+    default:
+        return 0;
+    }
+}
+
+/**
+  * @brief  获取本次（或最近一次）按住所越过的长按级数
+  * @param  handle: 按键句柄结构体指针
+  * @retval 0: 未达到长按，1 ~ long_stages: 已越过的级数（在 BTN_PRESS_UP 回调中可据此区分功能）
+  */
+uint8_t button_get_long_stage(Button* handle)
+{
+    if (!handle || !BTN_HOT(handle)) return 0;
+
+#if BUTTON_ENABLE_LONG_PRESS
+    return BTN_FIELD_LOAD(BTN_HOT(handle), long_stage);
+#else
+    return 0;
+#endif
+}
+
+/**
+  * @brief  获取最近一次按键释放/重复按下事件携带的时长
+  * @param  handle: 按键句柄结构体指针
+  * @retval BTN_PRESS_UP: 本次按下持续的节拍数；BTN_PRESS_REPEAT: 与上次松开的间隔节拍数
+  *
+  * @note 在对应事件的回调中调用即可得到本次测量值，无需在用户代码中读取时钟
+  */
+uint32_t button_get_duration(Button* handle)
+{
+    if (!handle) return 0;
+
+    return handle->duration;
+}
+
+#if BUTTON_ENABLE_PROFILE
+/**
+  * @brief  获取按键的时序配置
+  * @param  handle: 按键句柄结构体指针
+  * @retval 按键设置的配置，未设置时为默认配置
+  */
+static inline const ButtonProfile* button_profile(Button* handle)
+{
+    const ButtonProfile* profile = BTN_CFG_LOAD(&handle->profile);
+
+    return profile ? profile : &default_profile;
+}
+#endif
+
+/**
+  * @brief  取时序配置中的时间窗口
+  * @param  ticks: 配置值（节拍数）
+  * @retval 配置值，为 0 时返回 SHORT_TICKS
+  */
+static inline uint32_t button_window(uint32_t ticks)
+{
+    return ticks ? ticks : (uint32_t)SHORT_TICKS;
 }
 
 
@@ -152,173 +685,223 @@ int button_is_pressed(Button* handle)
   */
 static inline uint8_t button_read_level(Button* handle)
 {
+#if BUTTON_ENABLE_MMIO
+    if (handle->input_reg) return button_mmio_level(handle->input_reg, handle->input_mask);
+#endif
     // 调用 HAL 层的函数读取按键电平状态
     return handle->hal_button_level(handle->button_id);
 }
 
+#if BUTTON_ENABLE_COMPACT
+/**
+  * @brief  通过遍历表项读取按键电平（不访问按键结构体）
+  * @param  slot: 遍历表项
+  * @retval 按键电平（0 或 1）
+  */
+static inline uint8_t button_slot_level(const ButtonSlot* slot)
+{
+#if BUTTON_ENABLE_MMIO
+    if (slot->input_reg) return button_mmio_level(slot->input_reg, slot->input_mask);
+#endif
+    return slot->hal_button_level(slot->button_id);
+}
+#endif
+
 /**
   * @brief  按键驱动核心函数，驱动状态机
-  * @param  handle: 按键结构体句柄
+  * @param  hot: 按键热数据（默认布局下即按键结构体本身）
+  * @param  read_gpio_level: 本节拍读取到的按键GPIO电平
   * @retval None
   */
-static void button_handler(Button* handle)
+static void button_handler(ButtonHot* hot, uint8_t read_gpio_level)
 {
-	// 读取按键的GPIO电平状态
-	uint8_t read_gpio_level = button_read_level(handle);
-
-	// 如果当前状态不是空闲状态，则递增 ticks 计数器
-	if (handle->state > BTN_STATE_IDLE) 
-	{
-		handle->ticks++;
-	}
+	// 状态计时：进入状态时记录全局节拍，仅在需要判断阈值时做减法，按住期间每节拍无需写入
+	const uint32_t now = tick_count;
 
 	 /*------------按键去抖动处理---------------*/
 	 // 如果当前读取的电平与上次记录的电平不一致，表示电平发生了变化
-	if (read_gpio_level != handle->button_level) 
+	if (read_gpio_level != hot->button_level) 
 	{
-		//去抖动计数器累加：当电平变化时，去抖动计数器 (handle->debounce_cnt) 增加 1
+		//去抖动计数器累加：当电平变化时，去抖动计数器 (hot->debounce_cnt) 增加 1
 		//如果计数器的值大于等于设定的去抖动阈值 DEBOUNCE_TICKS（例如 3 次变化），那么认为电平变化是真正有效的（即去除掉了可能的抖动）。
-		//此时，更新按键的电平状态 (handle->button_level = read_gpio_level)，并将计数器重置为 0
-		if (++(handle->debounce_cnt) >= DEBOUNCE_TICKS) 
+		//此时，更新按键的电平状态 (hot->button_level = read_gpio_level)，并将计数器重置为 0
+		if (++(hot->debounce_cnt) >= DEBOUNCE_TICKS) 
 		{
-			handle->button_level = read_gpio_level; // 更新按钮电平状态
-			handle->debounce_cnt = 0;               // 重置去抖动计数器
+			hot->button_level = read_gpio_level; // 更新按钮电平状态
+			hot->debounce_cnt = 0;               // 重置去抖动计数器
 		}
 	} 
-	else 
+	else if (hot->debounce_cnt)
 	{
-		// 如果电平没有变化，重置去抖动计数器
-		handle->debounce_cnt = 0;
+		// 如果电平没有变化，重置去抖动计数器（已为 0 时不写，电平稳定的按键每节拍不产生存储）
+		hot->debounce_cnt = 0;
 	}
 
 	/*-----------------状态机-------------------*/
-	switch (handle->state) 
+	switch (hot->state) 
 	{
 	case BTN_STATE_IDLE:
         // 检测到按键被按下
-		if (handle->button_level == handle->active_level) 
+		if (hot->button_level == hot->active_level) 
 		{
 			// 设置事件为BTN_PRESS_DOWN，表示按键被按下
-			handle->event = (uint8_t)BTN_PRESS_DOWN;
+			hot->event = (uint8_t)BTN_PRESS_DOWN;
+#if BUTTON_ENABLE_LONG_PRESS
+			hot->long_stage = 0;      // 新的一次按住，长按级数清零
+#endif
 			// 调用按键按下的事件回调
 			EVENT_CB(BTN_PRESS_DOWN);
-			handle->ticks = 0;    // 重置ticks计数器
-			handle->repeat = 1;   // 设置重复计数器为1
-			handle->state = BTN_STATE_PRESS; // 转到按下状态
+			hot->state_tick = now;    // 记录进入按下状态的节拍
+#if BUTTON_ENABLE_MULTI_CLICK
+			hot->repeat = 1;   // 设置重复计数器为1
+#endif
+			hot->state = BTN_STATE_PRESS; // 转到按下状态
 		} 
-		else 
+		else if (hot->event != (uint8_t)BTN_NONE_PRESS)
 		{
-			handle->event = (uint8_t)BTN_NONE_PRESS; // 没有按键事件
+			hot->event = (uint8_t)BTN_NONE_PRESS; // 没有按键事件（只在离开其他事件时写一次）
 		}
 		break;
 
 	case BTN_STATE_PRESS:
 	 	// 按键被释放
-		if (handle->button_level != handle->active_level) 
+		if (hot->button_level != hot->active_level) 
 		{
 			// 设置事件为BTN_PRESS_UP，表示按键被释放
-			handle->event = (uint8_t)BTN_PRESS_UP;
+			hot->event = (uint8_t)BTN_PRESS_UP;
+			BTN_RECORD_DURATION(hot, now);    // 按下持续时长
 			// 调用按键释放的事件回调
 			EVENT_CB(BTN_PRESS_UP);
-			// 重置ticks计数器
-			handle->ticks = 0;
+#if BUTTON_ENABLE_MULTI_CLICK
+			// 记录进入新状态的节拍
+			hot->state_tick = now;
 			// 转到释放状态，等待超时
-			handle->state = BTN_STATE_RELEASE;
+			hot->state = BTN_STATE_RELEASE;
+#else
+			// 不识别连击：松开即为单击，无需等待双击窗口
+			hot->event = (uint8_t)BTN_SINGLE_CLICK;
+			EVENT_CB(BTN_SINGLE_CLICK);
+			hot->state = BTN_STATE_IDLE;
+#endif
 		} 
-		else if (handle->ticks > LONG_TICKS) // 按键没有被释放，并且长按事件被触发
+#if BUTTON_ENABLE_LONG_PRESS
+		else if (BTN_ELAPSED(hot, now) > BTN_PROFILE(hot)->long_ticks[0]) // 按键没有被释放，并且达到第 1 级长按阈值
 		{
 			// 设置事件为BTN_LONG_PRESS_START，表示长按开始
-			handle->event = (uint8_t)BTN_LONG_PRESS_START;
+			hot->event = (uint8_t)BTN_LONG_PRESS_START;
+			hot->long_stage = 1;
 			// 调用长按开始的事件回调
 			EVENT_CB(BTN_LONG_PRESS_START);
 			// 转到长按状态
-			handle->state = BTN_STATE_LONG_HOLD;
+			hot->state = BTN_STATE_LONG_HOLD;
 		}
+#endif
 		break;
 
+#if BUTTON_ENABLE_MULTI_CLICK
 	case BTN_STATE_RELEASE:
 	    // 按键被重新按下
-		if (handle->button_level == handle->active_level) 
+		if (hot->button_level == hot->active_level) 
 		{
 			// 设置事件为BTN_PRESS_DOWN
-			handle->event = (uint8_t)BTN_PRESS_DOWN;
+			hot->event = (uint8_t)BTN_PRESS_DOWN;
 			// 调用按键按下的事件回调
 			EVENT_CB(BTN_PRESS_DOWN);
 			// 如果按键重复次数小于最大值 15，递增重复计数
-			if (handle->repeat < PRESS_REPEAT_MAX_NUM) 
+			if (hot->repeat < PRESS_REPEAT_MAX_NUM) 
 			{
-				handle->repeat++;
+				hot->repeat++;
 			}
+			BTN_RECORD_DURATION(hot, now);    // 与上次松开的间隔
 			 // 调用重复按键的事件回调
 			EVENT_CB(BTN_PRESS_REPEAT);
-			// 重置ticks计数器
-			handle->ticks = 0;
+			// 记录进入新状态的节拍
+			hot->state_tick = now;
 			// 转到重复按状态
-			handle->state = BTN_STATE_REPEAT;
+			hot->state = BTN_STATE_REPEAT;
 		} 
-		else if (handle->ticks > SHORT_TICKS)  //按键已经松开，并且判断是否超过短按阈值
+		else if (BTN_ELAPSED(hot, now) > BTN_WINDOW(BTN_PROFILE(hot), click_ticks))  //按键已经松开，并且超过双击窗口
 		{
 			// 超时，根据重复次数判断点击类型
-			if (handle->repeat == 1) 
+			if (hot->repeat == 1) 
 			{
-				handle->event = (uint8_t)BTN_SINGLE_CLICK; // 设置事件为BTN_SINGLE_CLICK，表示单击
+				hot->event = (uint8_t)BTN_SINGLE_CLICK; // 设置事件为BTN_SINGLE_CLICK，表示单击
 				EVENT_CB(BTN_SINGLE_CLICK);                // 调用单击的事件回调
 			} 
-			else if (handle->repeat == 2)  
+			else if (hot->repeat == 2)  
 			{
-				handle->event = (uint8_t)BTN_DOUBLE_CLICK;   // 设置事件为BTN_DOUBLE_CLICK，表示双击
+				hot->event = (uint8_t)BTN_DOUBLE_CLICK;   // 设置事件为BTN_DOUBLE_CLICK，表示双击
 				EVENT_CB(BTN_DOUBLE_CLICK);                  // 调用双击的事件回调
 			}
-			handle->state = BTN_STATE_IDLE;                   // 转到空闲状态
+			hot->state = BTN_STATE_IDLE;                   // 转到空闲状态
 		}
 		break;
 
 	case BTN_STATE_REPEAT:
 	    //按键被释放
-		if (handle->button_level != handle->active_level)
+		if (hot->button_level != hot->active_level)
 		{
 			// 设置事件为BTN_PRESS_UP
-			handle->event = (uint8_t)BTN_PRESS_UP;
+			hot->event = (uint8_t)BTN_PRESS_UP;
+			BTN_RECORD_DURATION(hot, now);    // 本次（重复）按下的持续时长
 			// 调用按键释放的事件回调
 			EVENT_CB(BTN_PRESS_UP);
-			// 如果按键按下时间小于SHORT_TICKS，继续等待释放
-			if (handle->ticks < SHORT_TICKS) 
+			// 如果按键按下时间小于连击按下上限，继续等待下一次按下
+			if (BTN_ELAPSED(hot, now) < BTN_WINDOW(BTN_PROFILE(hot), repeat_press_ticks)) 
 			{
-				handle->ticks = 0;
-				handle->state = BTN_STATE_RELEASE;  // Continue waiting for more presses
+				hot->state_tick = now;
+				hot->state = BTN_STATE_RELEASE;  // Continue waiting for more presses
 			} 
 			else 
 			{
-				handle->state = BTN_STATE_IDLE;  // 按键释放后，回到空闲状态
+				hot->state = BTN_STATE_IDLE;  // 按键释放后，回到空闲状态
 			}
 		} 
-		else if (handle->ticks > SHORT_TICKS)   // 如果按下时间过长，视为正常按键
+		else if (BTN_ELAPSED(hot, now) > BTN_WINDOW(BTN_PROFILE(hot), repeat_press_ticks))   // 如果按下时间过长，视为正常按键
 		{
 			// Held down too long, treat as normal press
-			handle->state = BTN_STATE_PRESS;
+			hot->state = BTN_STATE_PRESS;
 		}
 		break;
+#endif
 
+#if BUTTON_ENABLE_LONG_PRESS
 	case BTN_STATE_LONG_HOLD:
 	    // 长按持续中
-		if (handle->button_level == handle->active_level) 
+		if (hot->button_level == hot->active_level) 
 		{
-			// 设置事件为BTN_LONG_PRESS_HOLD
-			handle->event = (uint8_t)BTN_LONG_PRESS_HOLD;
+#if BUTTON_ENABLE_LONG_HOLD
+			// 设置事件为BTN_LONG_PRESS_HOLD（已是该事件时不再写入）
+			if (hot->event != (uint8_t)BTN_LONG_PRESS_HOLD) hot->event = (uint8_t)BTN_LONG_PRESS_HOLD;
 			EVENT_CB(BTN_LONG_PRESS_HOLD);   // 调用长按持续的事件回调
+#endif
+
+#if BTN_HAS_LONG_STAGES
+			// 越过下一级长按阈值时产生一次 BTN_LONG_PRESS_STAGE（LONG_HOLD 的起点仍是本次按下的节拍）
+			const ButtonProfile* profile = BTN_PROFILE(hot);
+			if (hot->long_stage < profile->long_stages &&
+			    BTN_ELAPSED(hot, now) > profile->long_ticks[hot->long_stage])
+			{
+				hot->long_stage++;
+				hot->event = (uint8_t)BTN_LONG_PRESS_STAGE;
+				EVENT_CB(BTN_LONG_PRESS_STAGE);
+			}
+#endif
 		} 
 		else 
 		{
 			// // 长按释放
-			handle->event = (uint8_t)BTN_PRESS_UP; // 设置事件为BTN_PRESS_UP
+			hot->event = (uint8_t)BTN_PRESS_UP; // 设置事件为BTN_PRESS_UP
+			BTN_RECORD_DURATION(hot, now);       // 长按的总时长（LONG_HOLD 的起点是本次按下）
 			EVENT_CB(BTN_PRESS_UP);                // 调用按键释放的事件回调
-			handle->state = BTN_STATE_IDLE;         // 转到空闲状态
+			hot->state = BTN_STATE_IDLE;         // 转到空闲状态
 		}
 		break;
+#endif
 
 	default:
 		// 如果状态无效，重置为空闲状态
-		handle->state = BTN_STATE_IDLE;
+		hot->state = BTN_STATE_IDLE;
 		break;
 	}
 }
@@ -329,25 +912,51 @@ static void button_handler(Button* handle)
   * @retval 0: 添加成功
   *         -1: 已存在，不能重复添加
   *         -2: 参数无效（为空指针）
+  *         -3: 遍历表已满（仅分离布局：按键数超过内置遍历表时需先调用 button_compact() 提供更大的遍历表；
+  *             在回调中或并发模式下登记时同样检查，已登记的启动请求占用的表项计入）
   */
 int button_start(Button* handle)
 {
     // 参数检查：如果传入的按键指针为空，返回错误码 -2
     if (!handle) return -2;
 
-    // 遍历按键链表，检查该按键是否已经存在于链表中，防止重复添加
-    Button* target = head_handle;
-    while (target) {
-        if (target == handle)
+#if !BUTTON_ENABLE_CONCURRENT
+    if (!dispatching) {
+        // 通过 active 标记检查该按键是否已在链表中，防止重复添加（O(1)，无需遍历链表）
+        if (handle->active)
             return -1;  // 该按键已存在，返回错误码 -1
-        target = target->next;
+
+        // 将该按键插入链表头部（头插法）
+        if (button_link(handle) < 0)
+            return -3;  // 分离布局下遍历表已满
+        return 0;  // 添加成功，返回 0
     }
+#endif
 
-    // 将该按键插入链表头部（头插法）
-    handle->next = head_handle;  // 当前按键的 next 指向原链表头
-    head_handle = handle;        // 更新链表头指针为当前按键
+    // 回调中或并发模式：只登记请求，遍历结束（节拍边界）后生效
+    if (BTN_CFG_LOAD(&handle->active) && BTN_CFG_LOAD(&handle->pending_op) != BTN_OP_STOP)
+        return -1;
+#if BUTTON_LAYOUT_SPLIT
+    {
+        uint8_t op = BTN_OP_START;
+
+        if (BTN_CFG_LOAD(&handle->pending_op) == BTN_OP_START_SLOT) return 0;  // 已登记并预留
 
-    return 0;  // 添加成功，返回 0
+        // 未在运行的按键需要新表项：登记时预留，表满则立即返回 -3。
+        // 已在运行、等待停止的按键只需撤销停止；并发模式下运行状态可能在应用前改变，一律预留
+#if !BUTTON_ENABLE_CONCURRENT
+        if (!handle->active)
+#endif
+        {
+            if (button_slot_reserve() < 0) return -3;
+            op = BTN_OP_START_SLOT;
+        }
+        button_request(handle, op);
+    }
+#else
+    button_request(handle, BTN_OP_START);
+#endif
+    return 0;
 }
 
 
@@ -355,12 +964,241 @@ int button_start(Button* handle)
   * @brief  停止按键工作，从链表中移除指定按键句柄
   * @param  handle: 目标按键结构体指针
   * @retval None
+  *
+  * @note 在回调函数中调用时（或并发模式下），移除操作推迟到本次遍历结束后执行，
+  *       不会影响本节拍内其余按键的处理；并发模式下应等待 button_is_active() 返回 0 再复用该结构体。
+  *       分离布局下热数据随遍历表项释放，重新启动后从空闲状态开始（默认布局下状态保留在结构体中）
   */
 void button_stop(Button* handle)
 {
     // 参数检查：如果传入指针为 NULL，则直接返回
     if (!handle) return;
 
+#if !BUTTON_ENABLE_CONCURRENT
+    if (!dispatching) {
+        button_unlink(handle);
+        return;
+    }
+#endif
+
+    // 既不在工作链表中也没有待应用的请求：无需登记
+    if (!BTN_CFG_LOAD(&handle->active) && !BTN_CFG_LOAD(&handle->queued)) return;
+
+    button_request(handle, BTN_OP_STOP);
+}
+
+
+/**
+  * @brief  批量初始化按键数组
+  * @param  handles: 按键数组
+  * @param  count: 按键个数
+  * @param  pin_level: 读取按键GPIO电平的函数指针（所有按键共用，按 button_id 区分）
+  * @param  active_level: 按键被按下时的GPIO电平
+  * @param  first_id: 第一个按键的 button_id，其余依次加 1（超过 255 时回绕）
+  * @param  cb: 回调函数表（BTN_EVENT_COUNT 项，按事件索引，可为 NULL），复制到每个按键；关闭回调时忽略
+  * @retval 0: 成功，-2: 参数无效
+  *
+  * @note 等价于对每个按键调用 button_init() 和若干次 button_attach()，但只做一次参数检查
+  */
+int button_init_batch(Button* handles, uint16_t count, uint8_t(*pin_level)(uint8_t),
+                      uint8_t active_level, uint8_t first_id, const BtnCallback* cb)
+{
+    uint16_t i;
+
+    if (!handles || !pin_level) return -2;
+
+    for (i = 0; i < count; i++) {
+        button_init(&handles[i], pin_level, active_level, (uint8_t)(first_id + i));
+#if BUTTON_ENABLE_CALLBACKS
+        if (cb && BTN_CB_COUNT == BTN_EVENT_COUNT) {
+            memcpy(handles[i].cb, cb, sizeof(handles[i].cb));
+        } else if (cb) {
+            for (unsigned ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+                unsigned slot = button_cb_slot(ev);
+                if (slot != BTN_CB_NONE) handles[i].cb[slot] = cb[ev];
+            }
+        }
+#endif
+    }
+#if !BUTTON_ENABLE_CALLBACKS
+    (void)cb;
+#endif
+    return 0;
+}
+
+
+/**
+  * @brief  批量启动按键数组
+  * @param  handles: 按键数组（已初始化）
+  * @param  count: 按键个数
+  * @retval 实际启动的按键个数（已在链表中的按键被跳过）；-2: 参数无效；-3: 遍历表容量不足（仅分离布局，整批均未启动）
+  *
+  * @note 整批按键一次性拼接到链表头部，链表顺序与数组顺序相同以便顺序访问内存；
+  *       在回调中或并发模式下逐个登记请求，节拍边界生效；分离布局下表满时登记失败的按键不计入返回值
+  */
+int button_start_batch(Button* handles, uint16_t count)
+{
+    Button* first = NULL;
+    Button* last = NULL;
+    uint16_t i;
+    int started = 0;
+
+    if (!handles) return -2;
+
+    // 参数检查：一次遍历确认所有按键均已初始化
+    for (i = 0; i < count; i++) {
+        if (!handles[i].hal_button_level) return -2;
+    }
+
+#if !BUTTON_ENABLE_CONCURRENT
+    if (!dispatching) {
+#if BUTTON_LAYOUT_SPLIT
+        // 分离布局：先确认遍历表能容纳整批按键
+        uint16_t need = 0;
+        for (i = 0; i < count; i++) {
+            if (!handles[i].active) need++;
+        }
+        if (!slot_table || slot_count + need > slot_capacity) return -3;
+#endif
+
+        // 先在数组内部串成一条子链表，再整体拼接到链表头部
+        for (i = 0; i < count; i++) {
+            Button* handle = &handles[i];
+
+            if (handle->active) continue;
+            if (last) last->next = handle;
+            else first = handle;
+            last = handle;
+            handle->active = 1;
+            started++;
+        }
+        if (first) {
+            last->next = head_handle;
+            head_handle = first;
+            BTN_SCAN_INVALIDATE();
+#if BUTTON_ENABLE_COMPACT
+            // 遍历表整体重建一次，避免逐个有序插入（分离布局下容量已预先检查）
+            if (slot_table && button_compact(slot_table, slot_capacity) < 0) slot_table = NULL;
+#endif
+        }
+        return started;
+    }
+#endif
+
+    (void)first;
+    (void)last;
+    for (i = 0; i < count; i++) {
+        if (button_start(&handles[i]) == 0) started++;
+    }
+    return started;
+}
+
+
+/**
+  * @brief  批量停止按键数组
+  * @param  handles: 按键数组
+  * @param  count: 按键个数
+  * @retval 实际停止的按键个数；-2: 参数无效
+  *
+  * @note 先标记再一次遍历链表摘除所有被标记的按键，复杂度 O(链表长度 + count)
+  */
+int button_stop_batch(Button* handles, uint16_t count)
+{
+    uint16_t i;
+    int stopped = 0;
+
+    if (!handles) return -2;
+
+#if !BUTTON_ENABLE_CONCURRENT
+    if (!dispatching) {
+        Button** curr;
+
+        // 遍历之外 pending_op 空闲，借用为删除标记
+        for (i = 0; i < count; i++) {
+            if (handles[i].active) handles[i].pending_op = BTN_OP_STOP;
+        }
+
+        for (curr = &head_handle; *curr; ) {
+            Button* entry = *curr;
+
+            if (entry->pending_op == BTN_OP_STOP) {
+                *curr = entry->next;
+                entry->next = NULL;
+                entry->active = 0;
+                stopped++;
+            } else {
+                curr = &entry->next;
+            }
+        }
+        BTN_SCAN_INVALIDATE();
+
+#if BUTTON_ENABLE_COMPACT
+        // 遍历表同样一次过滤，保持原有顺序
+        if (slot_table) {
+            uint16_t r, w = 0;
+            for (r = 0; r < slot_count; r++) {
+                Button* owner = slot_table[r].handle;
+                if (owner->pending_op == BTN_OP_STOP) {
+#if BUTTON_LAYOUT_SPLIT
+                    owner->slot = NULL;
+#endif
+                    continue;
+                }
+                if (w != r) {
+                    slot_table[w] = slot_table[r];
+#if BUTTON_LAYOUT_SPLIT
+                    owner->slot = &slot_table[w];
+#endif
+                }
+                w++;
+            }
+            slot_count = w;
+        }
+#endif
+        for (i = 0; i < count; i++) {
+            if (handles[i].pending_op == BTN_OP_STOP) handles[i].pending_op = BTN_OP_NONE;
+        }
+        return stopped;
+    }
+#endif
+
+    for (i = 0; i < count; i++) {
+        if (BTN_CFG_LOAD(&handles[i].active)) stopped++;
+        button_stop(&handles[i]);
+    }
+    return stopped;
+}
+
+
+/**
+  * @brief  将按键插入工作链表头部
+  * @param  handle: 目标按键结构体指针（调用者保证其不在链表中）
+  * @retval 0: 成功，-1: 分离布局下遍历表已满（BUTTON_SPLIT_DEFAULT_SLOTS 为 0 时也可能未设置）
+  */
+static int button_link(Button* handle)
+{
+#if BUTTON_LAYOUT_SPLIT
+    // 分离布局：热数据必须先在遍历表中分配到位置
+    if (!slot_table || button_slot_insert(handle) < 0) return -1;
+#elif BUTTON_ENABLE_COMPACT
+    if (slot_table) button_slot_insert(handle);
+#endif
+
+    handle->next = head_handle;  // 当前按键的 next 指向原链表头
+    head_handle = handle;        // 更新链表头指针为当前按键
+    BTN_CFG_STORE(&handle->active, 1);
+    BTN_SCAN_INVALIDATE();
+    return 0;
+}
+
+
+/**
+  * @brief  从工作链表中移除按键
+  * @param  handle: 目标按键结构体指针
+  * @retval None
+  */
+static void button_unlink(Button* handle)
+{
     // 使用指向指针的指针来遍历链表，便于修改链表结构
     Button** curr;
 
@@ -374,6 +1212,11 @@ void button_stop(Button* handle)
 		{
             *curr = entry->next;     // 将当前指针指向下一个节点，实现删除操作
             entry->next = NULL;      // 清空被删除节点的 next 指针，防止野指针
+            BTN_CFG_STORE(&entry->active, 0);
+#if BUTTON_ENABLE_COMPACT
+            if (slot_table) button_slot_remove(entry);
+#endif
+            BTN_SCAN_INVALIDATE();
             return;                  // 删除完成，返回
         } 
 		else 
@@ -386,20 +1229,1438 @@ void button_stop(Button* handle)
 
 
 /**
-  * @brief  后台定时扫描处理函数，每隔固定时间（如5ms）被周期性调用
+  * @brief  节拍开始：计数加一，并发模式下应用待处理请求，否则进入遍历状态
+  * @param  None
+  * @retval None
+  */
+static inline void button_tick_begin(void)
+{
+#if BUTTON_ENABLE_EVENTFD
+    tick_ring_head = ring_head;
+#endif
+
+    tick_count++;
+#if BUTTON_ENABLE_MMIO
+    mmio_reg = NULL;    // 每节拍重新加载输入字
+#endif
+
+#if BUTTON_ENABLE_CONCURRENT
+    // 节拍边界：应用其他线程登记的启动/停止请求
+    if (BTN_LOAD_ACQUIRE(&pending_head)) button_apply_pending();
+#else
+    dispatching = 1;
+#endif
+}
+
+/**
+  * @brief  节拍结束：交付批量事件，应用遍历期间登记的请求，按需通知 eventfd
+  * @param  None
+  * @retval None
+  */
+static inline void button_tick_end(void)
+{
+#if BUTTON_EVENT_BATCH_SIZE
+    // 每节拍一次交付本节拍产生的事件
+    if (batch_count) button_batch_flush();
+#endif
+
+#if !BUTTON_ENABLE_CONCURRENT
+    dispatching = 0;
+#endif
+    // 批量应用本节拍回调中登记的请求
+    if (BTN_CFG_LOAD(&pending_head)) button_apply_pending();
+
+#if BUTTON_ENABLE_EVENTFD
+    // 本节拍产生了新事件：每个节拍最多写一次 eventfd，且消费者未取走前不再重复通知
+    if (ring_head != tick_ring_head && event_fd >= 0 &&
+        BTN_EXCHANGE_SEQ(&event_fd_pending, 1) == 0) {
+        uint64_t one = 1;
+        ssize_t ret = write(event_fd, &one, sizeof(one));
+        (void)ret;  // 计数器溢出时写失败也无妨，描述符仍处于可读状态
+    }
+#endif
+}
+
+
+/**
+  * @brief  后台定时扫描处理函数，每隔固定时间（如5ms）被周期性调用
   * @param  None
   * @retval None
   *
   * @note 此函数通常在定时器中断或RTOS定时任务中被调用，负责轮询所有注册的按键并处理其状态变化
   */
 void button_ticks(void)
+{
+    button_tick_begin();
+
+#if BUTTON_ENABLE_COMPACT
+    if (slot_table) {
+        // 顺序扫描连续遍历表：电平通过表项中的 HAL 副本读取，同时预取后续按键
+        uint16_t i;
+
+#if BUTTON_ENABLE_TWO_PHASE
+        uint8_t* levels = sample_levels;
+
+        if (levels && slot_count <= sample_capacity) {
+            // 第一阶段：读取全部电平（回调中的启动/停止被推迟，本节拍内表项不变）
+            if (sample_fn) sample_fn(levels, slot_table, slot_count);
+            else button_sample_levels(levels, slot_table, slot_count);
+#if BTN_HAS_AUX_SAMPLE
+            button_aux_sample();
+#endif
+
+            // 第二阶段：基于同一份快照运行状态机
+            for (i = 0; i < slot_count; i++) {
+#if !BUTTON_LAYOUT_SPLIT
+                if (i + BTN_PREFETCH_DISTANCE < slot_count)
+                    BTN_PREFETCH(slot_table[i + BTN_PREFETCH_DISTANCE].handle);
+#endif
+                button_handler(BTN_SLOT_HOT(&slot_table[i]), levels[i]);
+            }
+        } else
+#endif
+        for (i = 0; i < slot_count; i++) {
+            ButtonSlot* slot = &slot_table[i];
+
+#if !BUTTON_LAYOUT_SPLIT
+            // 默认布局下状态仍在按键结构体内，提前预取；分离布局下表项本身即热数据，顺序访问无需预取
+            if (i + BTN_PREFETCH_DISTANCE < slot_count)
+                BTN_PREFETCH(slot_table[i + BTN_PREFETCH_DISTANCE].handle);
+#endif
+            button_handler(BTN_SLOT_HOT(slot), button_slot_level(slot));
+        }
+    }
+#endif
+#if !BUTTON_LAYOUT_SPLIT
+#if BUTTON_ENABLE_COMPACT
+    else
+#endif
+    {
+        Button* target;
+
+        // 遍历所有已注册的按键句柄（通过链表 head_handle 管理）
+        // 回调中的启动/停止请求被推迟，遍历期间链表结构保持不变
+        for (target = head_handle; target; target = target->next) {
+            // 对每一个按键，执行状态机处理逻辑（包括去抖动、状态切换、事件判断等）
+            button_handler(target, button_read_level(target));
+        }
+    }
+#endif
+
+#if BUTTON_ENABLE_ENCODER
+    // 编码器在同一次调用中采样，不需要单独的定时器
+    if (encoder_head) button_encoder_scan();
+#endif
+#if BUTTON_ENABLE_SWITCH
+    if (switch_head) button_switch_scan();
+#endif
+#if BTN_HAS_AUX_SAMPLE
+    aux_sampled = 0;
+#endif
+
+    button_tick_end();
+}
+
+#if BUTTON_ENABLE_BUDGET_SCAN
+/**
+  * @brief  取出游标处的按键并读取其电平，游标所在节点随之前移
+  * @param  level: 输出电平
+  * @retval 按键热数据；NULL: 已到工作集末尾
+  */
+static inline ButtonHot* button_scan_fetch(uint8_t* level)
+{
+#if BUTTON_ENABLE_COMPACT
+    if (slot_table) {
+        ButtonSlot* slot;
+
+        if (scan_pos >= slot_count) return NULL;
+        slot = &slot_table[scan_pos];
+        *level = button_slot_level(slot);
+        return BTN_SLOT_HOT(slot);
+    }
+#endif
+#if !BUTTON_LAYOUT_SPLIT
+    {
+        Button* target = scan_next;
+
+        if (!scan_in_round || scan_next_topology != scan_topology) {
+            // 新一轮或链表结构变化过：按已服务个数从表头重新定位
+            uint16_t i;
+
+            target = head_handle;
+            for (i = 0; i < scan_pos && target; i++) target = target->next;
+            scan_next_topology = scan_topology;
+        }
+        if (!target) return NULL;
+
+        scan_next = target->next;
+        *level = button_read_level(target);
+        return target;
+    }
+#else
+    (void)level;
+    return NULL;
+#endif
+}
+
+/**
+  * @brief  游标是否已越过工作集中的最后一个按键
+  */
+static inline int button_scan_at_end(void)
+{
+#if BUTTON_ENABLE_COMPACT
+    if (slot_table) return scan_pos >= slot_count;
+#endif
+#if !BUTTON_LAYOUT_SPLIT
+    return scan_next == NULL;
+#else
+    return 1;
+#endif
+}
+
+/**
+  * @brief  结束当前轮：记录本轮占用的节拍数，游标回到开头
+  */
+static void button_scan_round_end(void)
+{
+    uint32_t ticks = tick_count - scan_round_start + 1;
+
+    scan_stats.rounds++;
+    scan_stats.round_ticks = ticks;
+    if (ticks > scan_stats.round_ticks_max) scan_stats.round_ticks_max = ticks;
+    scan_in_round = 0;
+    scan_pos = 0;
+}
+
+/**
+  * @brief  限时增量扫描：推进一个节拍，只服务工作集中的一段按键，下次调用从停下的位置继续
+  * @param  max_buttons: 本次最多服务的按键数，0 表示不限
+  * @param  clock: 计时函数，NULL 表示不限时
+  * @param  max_time: 时间预算（与 clock 同单位），每服务一个按键检查一次
+  * @retval 本次服务的按键数
+  *
+  * @note 代替 button_ticks() 周期调用，每次调用计为一个节拍。预算用完时至少已服务一个按键；
+  *       到达工作集末尾即结束一轮并返回，同一节拍内每个按键最多服务一次。
+  *       状态机计时基于节拍时间戳，服务间隔变长时长按、双击等判断仍按实际经过的节拍计算，
+  *       事件最多晚一个服务间隔产生；去抖按服务次数计数。电平逐个读取，不使用两阶段采样。
+  *       扫描途中启动/停止按键时，本轮个别按键可能被跳过或多服务一次。编码器和开关不受预算限制，每次调用都全部采样
+  */
+int button_ticks_budget(uint16_t max_buttons, ButtonClock clock, uint32_t max_time)
+{
+    uint32_t start = clock ? clock() : 0;
+    int served = 0;
+
+    button_tick_begin();
+
+    for (;;) {
+        uint8_t level = 0;
+        ButtonHot* hot = button_scan_fetch(&level);
+
+        if (!hot) {
+            // 工作集为空，或本轮中途有按键被移除而提前到达末尾
+            if (!scan_in_round) break;
+            button_scan_round_end();
+            if (served) break;
+            continue;
+        }
+        if (!scan_in_round) {
+            scan_in_round = 1;
+            scan_round_start = tick_count;
+        }
+
+        button_handler(hot, level);
+        served++;
+        scan_pos++;
+
+        if (button_scan_at_end()) {
+            button_scan_round_end();
+            break;
+        }
+        if (max_buttons && served >= max_buttons) break;
+        if (clock && (uint32_t)(clock() - start) >= max_time) break;
+    }
+
+#if BUTTON_ENABLE_ENCODER
+    // 编码器每节拍都要采样，否则快速转动时会漏掉相位跳变
+    if (encoder_head) button_encoder_scan();
+#endif
+#if BUTTON_ENABLE_SWITCH
+    // 开关每次只比较一次电平，开销很小，同样每节拍全部采样
+    if (switch_head) button_switch_scan();
+#endif
+
+    button_tick_end();
+    return served;
+}
+
+/**
+  * @brief  读取增量扫描统计
+  * @param  stats: 输出统计
+  * @retval None
+  *
+  * @note round_ticks 是最近一轮每个按键的服务间隔，lag 是当前轮已进行的节拍数，
+  *       二者之和是尚未扫到的按键距上次被服务的最长节拍数
+  */
+void button_scan_stats(ButtonScanStats* stats)
+{
+    if (!stats) return;
+
+    *stats = scan_stats;
+    stats->lag = scan_in_round ? tick_count - scan_round_start + 1 : 0;
+    stats->position = scan_in_round ? scan_pos : 0;
+}
+#endif
+
+/**
+  * @brief  查询按键是否在工作链表中（正在被 button_ticks() 扫描）
+  * @param  handle: 按键结构体指针
+  * @retval 1: 在工作链表中，0: 不在，-1: 参数错误
+  *
+  * @note 回调中及并发模式下 button_start()/button_stop() 在节拍边界才生效，
+  *       并发模式下调用 button_stop() 后应等待本函数返回 0 再释放或重新初始化该结构体
+  */
+int button_is_active(Button* handle)
+{
+    if (!handle) return -1;
+
+    return BTN_CFG_LOAD(&handle->active) ? 1 : 0;
+}
+
+/**
+  * @brief  登记启动/停止请求
+  * @param  handle: 按键结构体指针
+  * @param  op: BTN_OP_START、BTN_OP_START_SLOT 或 BTN_OP_STOP，同一节拍内后登记的请求覆盖先前的请求
+  * @retval None
+  */
+static void button_request(Button* handle, uint8_t op)
+{
+#if BUTTON_ENABLE_CONCURRENT
+    Button* head;
+
+#if BUTTON_LAYOUT_SPLIT
+    // 被覆盖的启动请求不再需要表项
+    if (BTN_EXCHANGE_SEQ(&handle->pending_op, op) == BTN_OP_START_SLOT) button_slot_unreserve();
+#else
+    BTN_STORE_SEQ(&handle->pending_op, op);
+#endif
+
+    // 已在待应用链表中则无需再次入队
+    if (BTN_EXCHANGE_SEQ(&handle->queued, 1)) return;
+
+    head = BTN_LOAD_ACQUIRE(&pending_head);
+    do {
+        handle->pending_next = head;
+    } while (!BTN_CAS_WEAK(&pending_head, &head, handle));
+#else
+#if BUTTON_LAYOUT_SPLIT
+    if (handle->pending_op == BTN_OP_START_SLOT) button_slot_unreserve();  // 被覆盖的启动请求不再需要表项
+#endif
+    handle->pending_op = op;
+
+    // 已在待应用链表中则无需再次入队
+    if (handle->queued) return;
+
+    handle->queued = 1;
+    handle->pending_next = pending_head;
+    pending_head = handle;
+#endif
+}
+
+/**
+  * @brief  批量应用所有待处理的启动/停止请求（仅由 button_ticks() 在遍历之外调用）
+  * @param  None
+  * @retval None
+  */
+static void button_apply_pending(void)
+{
+#if BUTTON_ENABLE_CONCURRENT
+    Button* entry = BTN_EXCHANGE_SEQ(&pending_head, (Button*)NULL);
+#else
+    Button* entry = pending_head;
+#endif
+    Button* prev = NULL;
+
+#if !BUTTON_ENABLE_CONCURRENT
+    pending_head = NULL;
+#endif
+
+    // 栈为后进先出，先反转为登记顺序，保证与直接调用时相同的链表顺序
+    while (entry) {
+        Button* next = entry->pending_next;
+        entry->pending_next = prev;
+        prev = entry;
+        entry = next;
+    }
+    entry = prev;
+
+    while (entry) {
+        // 先取出后继并清除入队标记，之后可以立即重新入队
+        Button* next = entry->pending_next;
+        uint8_t op;
+
+        BTN_CFG_STORE(&entry->queued, 0);
+#if BUTTON_ENABLE_CONCURRENT
+        op = BTN_EXCHANGE_SEQ(&entry->pending_op, (uint8_t)BTN_OP_NONE);
+#else
+        op = entry->pending_op;
+        entry->pending_op = BTN_OP_NONE;
+#endif
+#if BUTTON_LAYOUT_SPLIT
+        uint8_t reserved = (op == BTN_OP_START_SLOT);
+        if (reserved) op = BTN_OP_START;
+#endif
+
+        if (op == BTN_OP_START && !entry->active) {
+            button_link(entry);     // 分离布局下登记时已预留表项，不会失败
+        } else if (op == BTN_OP_STOP && entry->active) {
+            button_unlink(entry);
+        }
+#if BUTTON_LAYOUT_SPLIT
+        // 先插入再释放预留：其他线程看到的剩余容量只会偏少
+        if (reserved) button_slot_unreserve();
+#endif
+
+        entry = next;
+    }
+}
+
+#if BUTTON_ENABLE_COMPACT
+/**
+  * @brief  遍历表排序比较函数：按 HAL 函数、button_id、按键地址排序
+  */
+static int button_slot_compare(const void* a, const void* b)
+{
+    const ButtonSlot* x = (const ButtonSlot*)a;
+    const ButtonSlot* y = (const ButtonSlot*)b;
+    uintptr_t hx = (uintptr_t)x->hal_button_level;
+    uintptr_t hy = (uintptr_t)y->hal_button_level;
+
+    if (hx != hy) return hx < hy ? -1 : 1;
+#if BUTTON_ENABLE_MMIO
+    // 内存映射按键共用占位 HAL 函数，再按输入字地址排序，同一字的按键相邻以便共用一次加载
+    if (x->input_reg != y->input_reg) return (uintptr_t)x->input_reg < (uintptr_t)y->input_reg ? -1 : 1;
+#endif
+    if (x->button_id != y->button_id) return x->button_id < y->button_id ? -1 : 1;
+    if (x->handle != y->handle) return x->handle < y->handle ? -1 : 1;
+    return 0;
+}
+
+/**
+  * @brief  把已注册的按键整理为连续、有序的遍历表，之后 button_ticks() 顺序扫描该表
+  * @param  slots: 调用者提供的表项数组；NULL 表示关闭遍历表，恢复链表遍历
+  * @param  capacity: 数组容量，应为预计同时注册的最大按键数
+  * @retval 表项数；-1: 容量不足（仍使用原有遍历方式）；-2: 在回调中调用，或分离布局下传入 NULL
+  *
+  * @note 分离布局下本函数同时提供热数据存储：按键数超过内置遍历表（BUTTON_SPLIT_DEFAULT_SLOTS 项）时必须调用，
+  *       可在尚无按键时调用；更换数组（包括从内置遍历表更换）时原有状态被复制到新数组。
+  *       设置之后 button_start()/button_stop() 自动保持表有序（有序插入/删除，O(n) 内存移动），
+  *       容量不足时自动退回链表遍历，可再次调用本函数恢复。不能与 button_ticks() 并发调用
+  */
+int button_compact(ButtonSlot* slots, uint16_t capacity)
 {
     Button* target;
+    uint16_t n = 0;
+
+#if !BUTTON_ENABLE_CONCURRENT
+    if (dispatching) return -2;  // 遍历期间不能重建遍历表
+#endif
+    BTN_SCAN_INVALIDATE();
+
+#if BUTTON_LAYOUT_SPLIT
+    // 分离布局：热数据只存在于遍历表中，保留已有表项，只为尚无表项的按键追加新表项
+    if (!slots) return -2;
+
+    n = slot_table ? slot_count : 0;
+    for (target = head_handle; target; target = target->next) {
+        if (!target->slot) n++;
+    }
+    if (n + BTN_CFG_LOAD(&slot_reserved) > capacity) return -1;  // 并发模式下已登记的启动请求仍需表项
+
+    n = 0;
+    if (slot_table) {
+        if (slots != slot_table) memcpy(slots, slot_table, slot_count * sizeof(ButtonSlot));
+        n = slot_count;
+    }
+    for (target = head_handle; target; target = target->next) {
+        if (!target->slot) button_slot_fill(&slots[n++], target);
+    }
+
+    qsort(slots, n, sizeof(ButtonSlot), button_slot_compare);
+    button_slot_relink(slots, 0, n);
+#else
+    slot_table = NULL;
+    slot_count = 0;
+    if (!slots) return 0;
 
-    // 遍历所有已注册的按键句柄（通过链表 head_handle 管理）
     for (target = head_handle; target; target = target->next) {
-        // 对每一个按键，执行状态机处理逻辑（包括去抖动、状态切换、事件判断等）
-        button_handler(target);
+        if (n >= capacity) return -1;
+        button_slot_fill(&slots[n++], target);
+    }
+
+    qsort(slots, n, sizeof(ButtonSlot), button_slot_compare);
+#endif
+
+    slot_table = slots;
+    slot_count = n;
+    slot_capacity = capacity;
+    return n;
+}
+
+#if BUTTON_ENABLE_TWO_PHASE
+/**
+  * @brief  开启两阶段节拍：设置采样缓冲区和采样函数
+  * @param  levels: 采样缓冲区，levels[i] 保存遍历表第 i 项本节拍的电平；NULL 表示关闭，恢复逐个读取
+  * @param  capacity: 缓冲区容量，应不小于遍历表容量（表项数超过容量的节拍退回逐个读取）
+  * @param  sampler: 采样函数，NULL 表示对每个表项调用其 HAL 函数
+  * @retval 0: 成功，-2: 在回调中调用，或 levels 非空而容量为 0
+  *
+  * @note 采样函数在 button_ticks() 所在线程中调用，例如一次读取整个 GPIO 端口后按 button_id 拆分，
+  *       或从 DMA 采集的缓冲区中解码；只需写 levels[0 .. count-1]。不能与 button_ticks() 并发调用
+  */
+int button_set_sampler(uint8_t* levels, uint16_t capacity, ButtonSampler sampler)
+{
+#if !BUTTON_ENABLE_CONCURRENT
+    if (dispatching) return -2;  // 遍历期间不能更换缓冲区
+#endif
+    if (levels && !capacity) return -2;
+
+    sample_levels = levels;
+    sample_capacity = levels ? capacity : 0;
+    sample_fn = sampler;
+    return 0;
+}
+
+/**
+  * @brief  默认采样：逐个调用表项的 HAL 函数（与状态机分开，调用连续发生）
+  * @param  levels: 采样缓冲区
+  * @param  slots: 遍历表
+  * @param  count: 表项数
+  * @retval None
+  */
+static void button_sample_levels(uint8_t* levels, const ButtonSlot* slots, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        levels[i] = button_slot_level(&slots[i]);
+    }
+}
+
+#if BTN_HAS_AUX_SAMPLE
+/**
+  * @brief  读取正在扫描的编码器相位和开关电平，与按键电平构成同一份快照
+  * @param  None
+  * @retval None
+  */
+static void button_aux_sample(void)
+{
+#if BUTTON_ENABLE_ENCODER
+    for (ButtonEncoder* encoder = encoder_head; encoder; encoder = encoder->next) {
+        if (encoder->active == 1) encoder->sample = button_encoder_phase(encoder);
+    }
+#endif
+#if BUTTON_ENABLE_SWITCH
+    for (ButtonSwitch* sw = switch_head; sw; sw = sw->next) {
+        if (sw->active == 1) sw->sample = sw->hal_level(sw->switch_id) ? 1 : 0;
+    }
+#endif
+    aux_sampled = 1;
+}
+#endif
+#endif
+
+/**
+  * @brief  用按键配置填充表项；分离布局下同时初始化热数据（空闲状态）
+  */
+static void button_slot_fill(ButtonSlot* slot, Button* handle)
+{
+#if BUTTON_LAYOUT_SPLIT
+    memset(slot, 0, sizeof(ButtonSlot));
+    slot->event = (uint8_t)BTN_NONE_PRESS;
+    slot->state = BTN_STATE_IDLE;
+    slot->active_level = handle->active_level;
+    slot->button_level = !handle->active_level;
+#endif
+    slot->handle = handle;
+    slot->hal_button_level = handle->hal_button_level;
+#if BUTTON_ENABLE_MMIO
+    slot->input_reg = handle->input_reg;
+    slot->input_mask = handle->input_mask;
+#endif
+    slot->button_id = handle->button_id;
+}
+
+#if BUTTON_LAYOUT_SPLIT
+/**
+  * @brief  表项移动后更新按键指向热数据的指针
+  */
+static void button_slot_relink(ButtonSlot* slots, uint16_t from, uint16_t to)
+{
+    uint16_t i;
+
+    for (i = from; i < to; i++) {
+        slots[i].handle->slot = &slots[i];
+    }
+}
+#endif
+
+/**
+  * @brief  按排序位置把按键插入遍历表
+  * @retval 0: 成功；-1: 表已满（默认布局下同时关闭遍历表，退回链表遍历）
+  */
+static int button_slot_insert(Button* handle)
+{
+    ButtonSlot key;
+    uint16_t lo = 0, hi = slot_count;
+
+    if (slot_count >= slot_capacity) {
+#if !BUTTON_LAYOUT_SPLIT
+        slot_table = NULL;   // 容量不足，退回链表遍历
+#endif
+        return -1;
+    }
+
+    button_slot_fill(&key, handle);
+
+    // 二分查找插入位置
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (button_slot_compare(&slot_table[mid], &key) < 0) lo = (uint16_t)(mid + 1);
+        else hi = mid;
+    }
+
+    memmove(&slot_table[lo + 1], &slot_table[lo], (slot_count - lo) * sizeof(ButtonSlot));
+    slot_table[lo] = key;
+    BTN_CFG_STORE(&slot_count, (uint16_t)(slot_count + 1));  // 并发模式下其他线程预留表项时读取
+#if BUTTON_LAYOUT_SPLIT
+    button_slot_relink(slot_table, lo, slot_count);
+#endif
+    return 0;
+}
+
+/**
+  * @brief  从遍历表中删除按键，保持其余表项顺序
+  */
+static void button_slot_remove(Button* handle)
+{
+    uint16_t i;
+
+    for (i = 0; i < slot_count; i++) {
+        if (slot_table[i].handle == handle) {
+            memmove(&slot_table[i], &slot_table[i + 1], (slot_count - i - 1) * sizeof(ButtonSlot));
+            BTN_CFG_STORE(&slot_count, (uint16_t)(slot_count - 1));
+#if BUTTON_LAYOUT_SPLIT
+            handle->slot = NULL;
+            button_slot_relink(slot_table, i, slot_count);
+#endif
+            return;
+        }
+    }
+}
+
+#if BUTTON_LAYOUT_SPLIT
+/**
+  * @brief  为推迟的启动请求预留一个表项
+  * @retval 0: 成功，-1: 未设置遍历表，或表项数加已预留数达到容量
+  */
+static int button_slot_reserve(void)
+{
+#if BUTTON_ENABLE_CONCURRENT
+    uint16_t reserved = BTN_LOAD_ACQUIRE(&slot_reserved);
+
+    do {
+        if (!slot_table || BTN_CFG_LOAD(&slot_count) + reserved >= slot_capacity) return -1;
+    } while (!BTN_CAS_WEAK(&slot_reserved, &reserved, (uint16_t)(reserved + 1)));
+#else
+    if (!slot_table || slot_count + slot_reserved >= slot_capacity) return -1;
+    slot_reserved++;
+#endif
+    return 0;
+}
+
+/**
+  * @brief  释放一个预留的表项
+  */
+static void button_slot_unreserve(void)
+{
+#if BUTTON_ENABLE_CONCURRENT
+    BTN_FETCH_SUB_SEQ(&slot_reserved, 1);
+#else
+    slot_reserved--;
+#endif
+}
+#endif
+#endif
+
+#if BUTTON_ENABLE_ENCODER
+/*
+ * 正交解码表：下标为 (上次相位 << 2) | 本次相位，相位 = (A << 1) | B。
+ * 相邻格雷码跳变给出 +1/-1，无变化或两相同时跳变（丢步或抖动）记为 0，触点抖动来回跳变时自然抵消。
+ */
+static const int8_t encoder_table[16] = {
+     0, -1,  1,  0,
+     1,  0,  0, -1,
+    -1,  0,  0,  1,
+     0,  1, -1,  0
+};
+
+/**
+  * @brief  初始化编码器
+  * @param  encoder: 编码器结构体
+  * @param  pin_level: 读取通道电平的 HAL 函数（可与按键共用）
+  * @param  a_id: A 相通道 id
+  * @param  b_id: B 相通道 id
+  * @param  steps_per_detent: 每个定位格的相位跳变数，0 按 4 处理
+  * @retval None
+  */
+void button_encoder_init(ButtonEncoder* encoder, uint8_t(*pin_level)(uint8_t), uint8_t a_id, uint8_t b_id, uint8_t steps_per_detent)
+{
+    if (!encoder || !pin_level) return;
+
+    memset(encoder, 0, sizeof(ButtonEncoder));
+    encoder->hal_level = pin_level;
+    encoder->a_id = a_id;
+    encoder->b_id = b_id;
+    encoder->steps_per_detent = steps_per_detent ? (steps_per_detent > 64 ? 64 : steps_per_detent) : 4;
+}
+
+/**
+  * @brief  设置定位格回调
+  * @param  encoder: 编码器结构体
+  * @param  cb: 回调函数，NULL 表示取消
+  * @retval None
+  */
+void button_encoder_attach(ButtonEncoder* encoder, EncoderCallback cb)
+{
+    if (!encoder) return;
+
+    encoder->cb = cb;
+}
+
+/**
+  * @brief  开始扫描编码器：以当前相位为起点，之后每个节拍采样一次
+  * @param  encoder: 编码器结构体
+  * @retval 0: 成功，-1: 已在扫描，-2: 未初始化
+  *
+  * @note 编码器的启动/停止只能在 button_ticks() 所在线程（包括回调中）调用
+  */
+int button_encoder_start(ButtonEncoder* encoder)
+{
+    if (!encoder || !encoder->hal_level) return -2;
+    if (encoder->active == 1) return -1;
+
+    encoder->ab = button_encoder_phase(encoder);
+    encoder->sub = 0;
+#if BTN_HAS_AUX_SAMPLE
+    encoder->sample = encoder->ab;  // 采样阶段之后启动：本节拍扫描时无跳变
+#endif
+
+    // 停止后尚未被摘除：仍在链表中，恢复即可
+    if (encoder->active == 2) {
+        encoder->active = 1;
+        return 0;
+    }
+
+    // 插入链表头部；遍历中插入时本节拍不会扫描到它
+    encoder->next = encoder_head;
+    encoder_head = encoder;
+    encoder->active = 1;
+    return 0;
+}
+
+/**
+  * @brief  停止扫描编码器
+  * @param  encoder: 编码器结构体
+  * @retval None
+  *
+  * @note 遍历之外立即摘除；在回调中调用时只做标记，由本节拍的编码器扫描摘除
+  */
+void button_encoder_stop(ButtonEncoder* encoder)
+{
+    ButtonEncoder** curr;
+
+    if (!encoder || encoder->active != 1) return;
+
+#if !BUTTON_ENABLE_CONCURRENT
+    if (!dispatching) {
+        for (curr = &encoder_head; *curr; curr = &(*curr)->next) {
+            if (*curr == encoder) {
+                *curr = encoder->next;
+                encoder->next = NULL;
+                encoder->active = 0;
+                return;
+            }
+        }
+    }
+#endif
+
+    (void)curr;
+    encoder->active = 2;
+}
+
+/**
+  * @brief  获取累计位置
+  * @param  encoder: 编码器结构体
+  * @retval 自初始化以来的定位格数（顺时针为正）
+  */
+int32_t button_encoder_get_position(ButtonEncoder* encoder)
+{
+    if (!encoder) return 0;
+
+    return encoder->position;
+}
+
+/**
+  * @brief  估算当前转速
+  * @param  encoder: 编码器结构体
+  * @retval 每秒定位格数，带方向；静止超过 ENCODER_IDLE_TIME_MS、或换向/静止后只转过一格时为 0
+  *
+  * @note 由平滑后的定位格间隔换算，距上一次定位格的时间超过该间隔时按实际时间计算，转速随停顿逐渐下降。
+  *       分辨率受节拍限制，适合用于旋钮加速（转得越快每格步进越大）
+  */
+int32_t button_encoder_get_velocity(ButtonEncoder* encoder)
+{
+    uint32_t elapsed, interval;
+
+    if (!encoder || !encoder->interval) return 0;
+
+    elapsed = tick_count - encoder->detent_tick;
+    if (elapsed > ENCODER_IDLE_TICKS) return 0;
+
+    interval = encoder->interval > elapsed ? encoder->interval : elapsed;
+    return encoder->dir * (int32_t)(1000u / (interval * TICKS_INTERVAL));
+}
+
+/**
+  * @brief  产生一个定位格：更新位置和转速估计，调用回调
+  */
+static void button_encoder_detent(ButtonEncoder* encoder, int8_t dir)
+{
+    uint32_t dt = tick_count - encoder->detent_tick;
+
+    if (dir != encoder->dir || dt > ENCODER_IDLE_TICKS) {
+        // 换向或静止后重新开始估计，间隔在下一个定位格时才可知
+        encoder->interval = 0;
+    } else if (!encoder->interval) {
+        encoder->interval = (uint16_t)(dt ? dt : 1);
+    } else {
+        // 指数平滑（新间隔占 1/4），抑制手动旋转的节奏抖动
+        encoder->interval = (uint16_t)((encoder->interval * 3u + dt + 2u) / 4u);
+    }
+    encoder->detent_tick = tick_count;
+    encoder->dir = dir;
+    encoder->position += dir;
+
+    if (encoder->cb) encoder->cb(encoder, dir);
+}
+
+/**
+  * @brief  采样并解码所有编码器，同时摘除已停止的编码器（仅由 button_ticks() 调用）
+  */
+static void button_encoder_scan(void)
+{
+    ButtonEncoder** curr = &encoder_head;
+
+    while (*curr) {
+        ButtonEncoder* encoder = *curr;
+        uint8_t ab;
+        int8_t step;
+
+        if (encoder->active != 1) {
+            *curr = encoder->next;
+            encoder->next = NULL;
+            encoder->active = 0;
+            continue;
+        }
+
+#if BTN_HAS_AUX_SAMPLE
+        if (aux_sampled) ab = encoder->sample;
+        else
+#endif
+        ab = button_encoder_phase(encoder);
+        step = encoder_table[(encoder->ab << 2) | ab];
+        encoder->ab = ab;
+
+        if (step) {
+            encoder->sub = (int8_t)(encoder->sub + step);
+            if (encoder->sub >= (int8_t)encoder->steps_per_detent) {
+                encoder->sub = 0;
+                button_encoder_detent(encoder, 1);
+            } else if (encoder->sub <= -(int8_t)encoder->steps_per_detent) {
+                encoder->sub = 0;
+                button_encoder_detent(encoder, -1);
+            }
+        }
+        curr = &encoder->next;
+    }
+}
+#endif
+
+#if BUTTON_ENABLE_SWITCH
+/**
+  * @brief  初始化开关
+  * @param  sw: 开关结构体
+  * @param  pin_level: 读取开关电平的 HAL 函数（可与按键共用）
+  * @param  active_level: 接通时的电平
+  * @param  switch_id: 开关 id
+  * @retval None
+  */
+void button_switch_init(ButtonSwitch* sw, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t switch_id)
+{
+    if (!sw || !pin_level) return;
+
+    memset(sw, 0, sizeof(ButtonSwitch));
+    sw->hal_level = pin_level;
+    sw->switch_id = switch_id;
+    sw->active_level = active_level ? 1 : 0;
+    sw->level = !sw->active_level;
+}
+
+/**
+  * @brief  设置状态变化回调
+  * @param  sw: 开关结构体
+  * @param  cb: 回调函数，NULL 表示取消
+  * @retval None
+  */
+void button_switch_attach(ButtonSwitch* sw, SwitchCallback cb)
+{
+    if (!sw) return;
+
+    sw->cb = cb;
+}
+
+/**
+  * @brief  开始扫描开关：以当前电平为初始状态（不产生回调），之后每个节拍采样一次
+  * @param  sw: 开关结构体
+  * @retval 0: 成功，-1: 已在扫描，-2: 未初始化
+  *
+  * @note 开关的启动/停止只能在 button_ticks() 所在线程（包括回调中）调用
+  */
+int button_switch_start(ButtonSwitch* sw)
+{
+    if (!sw || !sw->hal_level) return -2;
+    if (sw->active == 1) return -1;
+
+    // 自锁开关上电时可能处于任一位置，直接采用当前电平
+    sw->level = sw->hal_level(sw->switch_id) ? 1 : 0;
+    sw->debounce_cnt = 0;
+#if BTN_HAS_AUX_SAMPLE
+    sw->sample = sw->level;
+#endif
+
+    // 停止后尚未被摘除：仍在链表中，恢复即可
+    if (sw->active == 2) {
+        sw->active = 1;
+        return 0;
+    }
+
+    sw->next = switch_head;
+    switch_head = sw;
+    sw->active = 1;
+    return 0;
+}
+
+/**
+  * @brief  停止扫描开关
+  * @param  sw: 开关结构体
+  * @retval None
+  *
+  * @note 遍历之外立即摘除；在回调中调用时只做标记，由本节拍的开关扫描摘除
+  */
+void button_switch_stop(ButtonSwitch* sw)
+{
+    ButtonSwitch** curr;
+
+    if (!sw || sw->active != 1) return;
+
+#if !BUTTON_ENABLE_CONCURRENT
+    if (!dispatching) {
+        for (curr = &switch_head; *curr; curr = &(*curr)->next) {
+            if (*curr == sw) {
+                *curr = sw->next;
+                sw->next = NULL;
+                sw->active = 0;
+                return;
+            }
+        }
     }
+#endif
+
+    (void)curr;
+    sw->active = 2;
+}
+
+/**
+  * @brief  查询开关是否接通（去抖后）
+  * @param  sw: 开关结构体
+  * @retval 1: 接通，0: 断开，-1: 参数错误
+  */
+int button_switch_is_on(ButtonSwitch* sw)
+{
+    if (!sw) return -1;
+
+    return (sw->level == sw->active_level) ? 1 : 0;
+}
+
+/**
+  * @brief  采样所有开关，去抖后报告通断变化，同时摘除已停止的开关（仅由 button_ticks() 调用）
+  */
+static void button_switch_scan(void)
+{
+    ButtonSwitch** curr = &switch_head;
+
+    while (*curr) {
+        ButtonSwitch* sw = *curr;
+        uint8_t level;
+
+        if (sw->active != 1) {
+            *curr = sw->next;
+            sw->next = NULL;
+            sw->active = 0;
+            continue;
+        }
+        curr = &sw->next;
+
+        // 与按键相同的去抖：连续 DEBOUNCE_TICKS 次读到新电平才确认
+#if BTN_HAS_AUX_SAMPLE
+        if (aux_sampled) level = sw->sample;
+        else
+#endif
+        level = sw->hal_level(sw->switch_id) ? 1 : 0;
+        if (level == sw->level) {
+            sw->debounce_cnt = 0;
+            continue;
+        }
+        if (++sw->debounce_cnt < DEBOUNCE_TICKS) continue;
+
+        sw->level = level;
+        sw->debounce_cnt = 0;
+        if (sw->cb) sw->cb(sw, level == sw->active_level);
+    }
+}
+#endif
+
+#if BUTTON_ENABLE_LOGIC
+/**
+  * @brief  登记逻辑按键的物理输入和表达式
+  * @param  inputs: 物理输入表，下标即表达式中的位号
+  * @param  input_count: 输入数（0 ~ 32）
+  * @param  logic: 表达式表，下标即逻辑按键的 button_id
+  * @param  logic_count: 表达式数
+  * @retval 0: 成功，-2: 参数无效或在回调中调用
+  *
+  * @note 两张表由调用者持有，之后不能释放。登记后用 button_init(&btn, button_logic_level, 1, 序号) 初始化逻辑按键。
+  *       不能与 button_ticks() 并发调用
+  */
+int button_logic_init(const ButtonInput* inputs, uint8_t input_count, const ButtonLogic* logic, uint8_t logic_count)
+{
+    uint8_t i;
+
+#if !BUTTON_ENABLE_CONCURRENT
+    if (dispatching) return -2;  // 遍历期间不能更换表达式
+#endif
+    if (input_count > 32 || (input_count && !inputs) || (logic_count && !logic)) return -2;
+    for (i = 0; i < input_count; i++) {
+        if (!inputs[i].hal_level) return -2;
+    }
+
+    logic_inputs = inputs;
+    logic_input_count = input_count;
+    logic_exprs = logic;
+    logic_expr_count = logic_count;
+    logic_tick = tick_count - 1;  // 下一次读取时重新采样
+    return 0;
+}
+
+/**
+  * @brief  逻辑按键的 HAL 函数：对本节拍的输入快照求值
+  * @param  logic_id: 表达式序号（即逻辑按键的 button_id）
+  * @retval 1: 表达式成立，0: 不成立或序号无效
+  *
+  * @note 节拍内第一次调用时读取全部物理输入，之后的调用不再访问 GPIO。逻辑按键的有效电平应设为 1
+  */
+uint8_t button_logic_level(uint8_t logic_id)
+{
+    const ButtonLogic* expr;
+    uint32_t state;
+
+    if (logic_id >= logic_expr_count) return 0;
+
+    if (logic_tick != tick_count) {
+        uint8_t i;
+
+        state = 0;
+        for (i = 0; i < logic_input_count; i++) {
+            const ButtonInput* in = &logic_inputs[i];
+            if (!in->hal_level(in->input_id) == !in->active_level) state |= 1u << i;
+        }
+        logic_state = state;
+        logic_tick = tick_count;
+    }
+
+    state = logic_state;
+    expr = &logic_exprs[logic_id];
+    return ((state & expr->all) == expr->all && !(state & expr->none) &&
+            (!expr->any || (state & expr->any))) ? 1 : 0;
+}
+
+/**
+  * @brief  获取最近一次采样的输入快照
+  * @param  None
+  * @retval 位 i 为 1 表示输入表第 i 项有效
+  */
+uint32_t button_logic_inputs(void)
+{
+    return logic_state;
+}
+#endif
+
+#if BUTTON_ENABLE_POOL
+/**
+  * @brief  初始化按键池
+  * @param  pool: 按键池结构体指针
+  * @param  storage: 调用者提供的按键数组（静态或在初始化阶段分配）
+  * @param  capacity: 数组容量
+  * @retval 0: 成功，-2: 参数无效
+  */
+int button_pool_init(ButtonPool* pool, Button* storage, uint16_t capacity)
+{
+    if (!pool || !storage || !capacity) return -2;
+
+    pool->storage = storage;
+    pool->capacity = capacity;
+    pool->used = 0;
+    pool->live = 0;
+    pool->free_list = NULL;
+    return 0;
+}
+
+/**
+  * @brief  从按键池中创建并初始化一个按键（O(1)）
+  * @param  pool: 按键池结构体指针
+  * @param  pin_level: 读取按键GPIO电平的函数指针
+  * @param  active_level: 按键被按下时的GPIO电平
+  * @param  button_id: 按键的唯一标识符
+  * @retval 按键句柄；按键池已满或参数无效时返回 NULL
+  *
+  * @note 优先复用最近释放的槽位（缓存仍热），否则从高水位处顺序分配，活动按键集中在数组前部。
+  *       创建后与 button_init() 的结果相同，需调用 button_start() 开始扫描
+  */
+Button* button_create(ButtonPool* pool, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t button_id)
+{
+    Button* handle;
+
+    if (!pool || !pin_level) return NULL;
+
+    if (pool->free_list) {
+        handle = pool->free_list;
+        pool->free_list = handle->next;
+    } else if (pool->used < pool->capacity) {
+        handle = &pool->storage[pool->used++];
+    } else {
+        return NULL;  // 按键池已满
+    }
+
+    pool->live++;
+    button_init(handle, pin_level, active_level, button_id);
+    return handle;
+}
+
+/**
+  * @brief  停止按键并将其归还按键池（O(1)，不含停止时的链表查找）
+  * @param  pool: 按键池结构体指针
+  * @param  handle: 由 button_create() 创建的按键句柄
+  * @retval 0: 成功
+  *         -1: 停止请求已登记但尚未生效（回调中或并发模式下），应在 button_is_active() 返回 0 后再次调用
+  *         -2: 参数无效（不属于该按键池或已被释放）
+  */
+int button_destroy(ButtonPool* pool, Button* handle)
+{
+    if (!pool || !handle) return -2;
+
+    // 必须是本按键池中已分配的槽位
+    if (handle < pool->storage || handle >= pool->storage + pool->used ||
+        ((const char*)handle - (const char*)pool->storage) % sizeof(Button) != 0 ||
+        !handle->hal_button_level) return -2;
+
+    button_stop(handle);
+    if (BTN_CFG_LOAD(&handle->active) || BTN_CFG_LOAD(&handle->queued)) return -1;
+
+    handle->hal_button_level = NULL;  // 标记为空闲，防止重复释放
+    handle->next = pool->free_list;
+    pool->free_list = handle;
+    pool->live--;
+    return 0;
+}
+#endif
+
+#if BUTTON_EVENT_RING_SIZE || BUTTON_EVENT_BATCH_SIZE
+/**
+  * @brief  填写一条事件记录
+  * @param  rec: 目标记录
+  * @param  hot: 产生事件的按键热数据
+  * @param  ev: 事件类型
+  * @retval None
+  */
+static inline void button_event_fill(ButtonEventRecord* rec, ButtonHot* hot, ButtonEvent ev)
+{
+    rec->button = BTN_OWNER(hot);
+    rec->tick = tick_count;
+    rec->event = (uint8_t)ev;
+    rec->repeat = BTN_REPEAT(hot);
+    rec->duration = (ev == BTN_PRESS_UP || ev == BTN_PRESS_REPEAT) ? BTN_OWNER(hot)->duration : 0;
+}
+#endif
+
+#if BUTTON_EVENT_BATCH_SIZE
+/**
+  * @brief  设置批量事件处理函数
+  * @param  sink: 处理函数，NULL 表示不交付（事件被丢弃）
+  * @retval None
+  *
+  * @note 处理函数在 button_ticks() 所在线程中调用，可在其中调用 button_start()/button_stop()（节拍边界生效）
+  */
+void button_set_batch_sink(ButtonBatchSink sink)
+{
+    BTN_CFG_STORE(&batch_sink, sink);
+}
+
+/**
+  * @brief  把事件追加到本批记录（仅由 button_ticks() 调用），数组已满时先交付已有记录
+  * @param  hot: 产生事件的按键热数据
+  * @param  ev: 事件类型
+  * @retval None
+  */
+static void button_batch_append(ButtonHot* hot, ButtonEvent ev)
+{
+    if (batch_count == BUTTON_EVENT_BATCH_SIZE) button_batch_flush();
+
+    button_event_fill(&batch_buf[batch_count++], hot, ev);
+}
+
+/**
+  * @brief  把本批记录交给处理函数并清空
+  * @param  None
+  * @retval None
+  */
+static void button_batch_flush(void)
+{
+    ButtonBatchSink sink = BTN_CFG_LOAD(&batch_sink);
+    int count = batch_count;
+
+    batch_count = 0;
+    if (sink) sink(batch_buf, count);
+}
+#endif
+
+#if BUTTON_EVENT_RING_SIZE
+/**
+  * @brief  将事件写入环形缓冲区（仅由 button_ticks() 调用）
+  * @param  hot: 产生事件的按键热数据
+  * @param  ev: 事件类型
+  * @retval None
+  */
+static void button_event_publish(ButtonHot* hot, ButtonEvent ev)
+{
+    uint32_t head = ring_head;
+
+    button_event_fill(&ring_buf[head & (BUTTON_EVENT_RING_SIZE - 1)], hot, ev);
+
+    // 先写记录，再发布序号
+    BTN_STORE_SEQ(&ring_head, head + 1);
+}
+
+/**
+  * @brief  初始化订阅者，游标指向当前最新位置（只接收之后发布的事件）
+  * @param  sub: 订阅者结构体指针（由调用者分配）
+  * @retval None
+  *
+  * @note 订阅者无需向生产者注册，任意数量的订阅者都不会增加 button_ticks() 的开销
+  */
+void button_subscriber_init(ButtonSubscriber* sub)
+{
+    if (!sub) return;
+
+    memset(sub, 0, sizeof(ButtonSubscriber));
+    sub->cursor = BTN_LOAD_ACQUIRE(&ring_head);
+}
+
+/**
+  * @brief  获取订阅者可读的一段连续记录（原地读取，不复制）
+  * @param  sub: 订阅者结构体指针
+  * @param  count: 输出可读记录条数（到缓冲区末尾为止，回绕部分需再次调用）
+  * @retval 指向第一条可读记录的指针；无新事件时返回 NULL
+  *
+  * @note 处理完成后必须调用 button_subscriber_commit() 推进游标并校验记录是否在处理期间被覆盖
+  */
+const ButtonEventRecord* button_subscriber_peek(ButtonSubscriber* sub, int* count)
+{
+    uint32_t head, lag, idx, n;
+
+    if (!sub || !count) return NULL;
+
+    head = BTN_LOAD_SEQ(&ring_head);
+    lag = head - sub->cursor;
+
+    // 落后超过可用容量：最旧的记录已被覆盖，直接跳到仍然有效的最旧记录
+    if (lag > BTN_RING_USABLE) {
+        sub->overruns += lag - BTN_RING_USABLE;
+        sub->cursor = head - BTN_RING_USABLE;
+        lag = BTN_RING_USABLE;
+    }
+    if (lag > sub->lag_max) sub->lag_max = lag;
+
+    idx = sub->cursor & (BUTTON_EVENT_RING_SIZE - 1);
+    n = BUTTON_EVENT_RING_SIZE - idx;
+    if (n > lag) n = lag;
+
+    *count = (int)n;
+    return n ? &ring_buf[idx] : NULL;
+}
+
+/**
+  * @brief  确认已处理 n 条记录，推进订阅者游标
+  * @param  sub: 订阅者结构体指针
+  * @param  n: 已处理的记录条数（不超过 peek 返回的 count）
+  * @retval 本批次开头在处理期间被生产者覆盖的记录条数；0 表示全部有效
+  *
+  * @note 序号为 s 的槽位在生产者写入 s + BUTTON_EVENT_RING_SIZE 时被覆盖，
+  *       因此处理结束后重新读取 ring_head 即可判断哪些记录可能不完整（界限与 peek 相同，见 BTN_RING_USABLE）
+  */
+int button_subscriber_commit(ButtonSubscriber* sub, int n)
+{
+    uint32_t head, torn = 0;
+
+    if (!sub || n <= 0) return 0;
+
+    BTN_FENCE_ACQUIRE();
+    head = BTN_LOAD_ACQUIRE(&ring_head);
+    if (head - sub->cursor > BTN_RING_USABLE) {
+        torn = head - sub->cursor - BTN_RING_USABLE;
+        if (torn > (uint32_t)n) torn = (uint32_t)n;
+        sub->overruns += torn;
+    }
+
+    sub->cursor += (uint32_t)n;
+    return (int)torn;
+}
+
+/**
+  * @brief  获取订阅者当前落后生产者的事件条数
+  * @param  sub: 订阅者结构体指针
+  * @retval 未读事件条数；超过可用容量（BUTTON_EVENT_RING_SIZE，生产者可能同时运行时为 BUTTON_EVENT_RING_SIZE - 1）表示已有事件被覆盖
+  */
+uint32_t button_subscriber_lag(const ButtonSubscriber* sub)
+{
+    if (!sub) return 0;
+
+    return BTN_LOAD_ACQUIRE(&ring_head) - sub->cursor;
+}
+
+/**
+  * @brief  从事件环形缓冲区读取事件（非阻塞，内置单消费者）
+  * @param  out: 输出数组
+  * @param  max: 输出数组容量
+  * @retval 实际读取的事件条数；等于 max 时缓冲区中可能仍有事件
+  *
+  * @note 生产者从不等待消费者，读取过程中被覆盖的记录会被丢弃并计入 button_event_dropped()
+  */
+int button_event_read(ButtonEventRecord* out, int max)
+{
+    const ButtonEventRecord* recs;
+    int total = 0;
+    int n, torn;
+
+    if (!out || max <= 0) return 0;
+
+    // 缓冲区回绕时分两段读取
+    while (total < max && (recs = button_subscriber_peek(&default_sub, &n)) != NULL) {
+        if (n > max - total) n = max - total;
+        memcpy(out + total, recs, n * sizeof(*out));
+        torn = button_subscriber_commit(&default_sub, n);
+        if (torn) memmove(out + total, out + total + torn, (n - torn) * sizeof(*out));
+        total += n - torn;
+    }
+
+    return total;
+}
+
+/**
+  * @brief  获取因缓冲区溢出而丢失的事件总数
+  * @param  None
+  * @retval 丢失的事件数
+  */
+uint32_t button_event_dropped(void)
+{
+    return default_sub.overruns;
+}
+#endif
+
+#if BUTTON_ENABLE_EVENTFD
+/**
+  * @brief  创建事件通知描述符（eventfd，非阻塞）
+  * @param  None
+  * @retval 描述符；已打开时返回已有描述符；失败返回 -1
+  *
+  * @note 描述符可读表示事件缓冲区中有新事件，可直接加入 epoll/poll/select
+  */
+int button_eventfd_open(void)
+{
+    int fd;
+
+    if (event_fd >= 0) return event_fd;
+
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) return -1;
+
+    BTN_STORE_SEQ(&event_fd_pending, 0);
+    BTN_STORE_RELEASE(&event_fd, fd);
+    return fd;
+}
+
+/**
+  * @brief  关闭事件通知描述符
+  * @param  None
+  * @retval None
+  *
+  * @note 调用前应确保 button_ticks() 不再并发执行
+  */
+void button_eventfd_close(void)
+{
+    int fd = event_fd;
+
+    if (fd < 0) return;
+    BTN_STORE_RELEASE(&event_fd, -1);
+    close(fd);
+}
+
+/**
+  * @brief  获取事件通知描述符
+  * @param  None
+  * @retval 描述符，未打开时返回 -1
+  */
+int button_eventfd(void)
+{
+    return event_fd;
+}
+
+/**
+  * @brief  在描述符可读后批量取出事件
+  * @param  out: 输出数组
+  * @param  max: 输出数组容量
+  * @retval 实际读取的事件条数；等于 max 时应继续调用直到小于 max
+  *
+  * @note 先清除通知状态再读缓冲区，保证不会漏掉读取期间新发布的事件
+  */
+int button_eventfd_drain(ButtonEventRecord* out, int max)
+{
+    uint64_t count;
+
+    if (event_fd >= 0) {
+        ssize_t ret = read(event_fd, &count, sizeof(count));
+        (void)ret;  // EAGAIN 表示计数器已为 0
+    }
+    BTN_STORE_SEQ(&event_fd_pending, 0);
+
+    return button_event_read(out, max);
 }
+#endif
 
@@ -9,32 +9,56 @@
 #include <stdint.h>
 #include <string.h>
 
-// 配置常量 - 可以根据需求进行修改
-/* 定义定时器中断的时间间隔为5毫秒。这个间隔决定了系统的时间粒度，通常用于计时和控制事件的触发频率。 */
+#include "multi_button_config.h"
 
-#define TICKS_INTERVAL          5    // ms - 定时器中断的间隔时间（5毫秒）
+#if DEBOUNCE_TICKS < 1 || DEBOUNCE_TICKS > 7
+#error "DEBOUNCE_TICKS must be 1..7 (DEBOUNCE_TIME_MS / TICKS_INTERVAL)"
+#endif
 
-/* 定义去抖动计数的深度为3。去抖动机制用于避免由于按键物理弹跳引起的多次触发。这里的3表示按键状态变化时，必须连续3次电平稳定才会认为状态有效。 */
-#define DEBOUNCE_TICKS          3    // 最大为7（0 ~ 7）- 去抖动过滤深度
+#if PRESS_REPEAT_MAX_NUM < 1 || PRESS_REPEAT_MAX_NUM > 15
+#error "PRESS_REPEAT_MAX_NUM must be 1..15"
+#endif
 
-/* 计算短按的阈值。假设短按事件发生的时间限制为300毫秒，通过将其除以定时器中断间隔来得到对应的计数值。
- *  例如，TICKS_INTERVAL = 5，则 SHORT_TICKS = 300 / 5 = 60，表示短按的阈值为60个定时器中断。 
-*/
-#define SHORT_TICKS             (300 / TICKS_INTERVAL)   // // 短按阈值
+#if BUTTON_EVENT_RING_SIZE & (BUTTON_EVENT_RING_SIZE - 1)
+#error "BUTTON_EVENT_RING_SIZE must be a power of two"
+#endif
 
+#if BUTTON_LONG_STAGE_MAX < 1 || BUTTON_LONG_STAGE_MAX > 15
+#error "BUTTON_LONG_STAGE_MAX must be 1..15"
+#endif
 
-/* 计算长按的阈值。假设长按事件发生的时间限制为1000毫秒，同样通过定时器中断间隔进行转换。
- *  例如，TICKS_INTERVAL = 5，则 LONG_TICKS = 1000 / 5 = 200，表示长按的阈值为200个定时器中断。
- */
-#define LONG_TICKS              (1000 / TICKS_INTERVAL)  // 长按阈值
+#if BUTTON_LAYOUT_FAST
+#define BTN_BITS(n)                     // 快速布局：整字节字段
+#else
+#define BTN_BITS(n)             : n     // 紧凑布局：位域
+#endif
 
-/* 定义按键重复按下的最大次数为15。用于在按键被持续按住时，控制事件触发的最大次数，防止触发无限循环事件。 */
-#define PRESS_REPEAT_MAX_NUM    15   // 最大重复计数值
+#if BUTTON_LAYOUT_SPLIT && !BUTTON_ENABLE_COMPACT
+#error "BUTTON_LAYOUT_SPLIT requires BUTTON_ENABLE_COMPACT"
+#endif
+
+#if BUTTON_ENABLE_TWO_PHASE && !BUTTON_ENABLE_COMPACT
+#error "BUTTON_ENABLE_TWO_PHASE requires BUTTON_ENABLE_COMPACT"
+#endif
+
+#if BUTTON_ENABLE_EVENTFD && !BUTTON_EVENT_RING_SIZE
+#error "BUTTON_ENABLE_EVENTFD requires BUTTON_EVENT_RING_SIZE > 0"
+#endif
+
+#if (BUTTON_ENABLE_CONCURRENT || BUTTON_ENABLE_EVENTFD) && BUTTON_EVENT_RING_SIZE == 1
+#error "BUTTON_EVENT_RING_SIZE must be at least 2 when the producer runs concurrently with readers"
+#endif
 
 
 // Forward declaration
 typedef struct _Button Button;
 
+#if BUTTON_ENABLE_MMIO
+// Memory-mapped input word
+// 内存映射输入字的类型
+typedef BUTTON_MMIO_WORD ButtonInputWord;
+#endif
+
 // Button callback function type
 typedef void (*BtnCallback)(Button* btn_handle);
 
@@ -48,10 +72,28 @@ typedef enum {
     BTN_DOUBLE_CLICK,       // double click completed, 双击事件完成
     BTN_LONG_PRESS_START,   // long press started, 长按事件开始
     BTN_LONG_PRESS_HOLD,    // long press holding, 长按事件持续中
+    BTN_LONG_PRESS_STAGE,   // further long press stage reached, 达到第 2 级及以后的长按阈值
     BTN_EVENT_COUNT,        // total number of events, 按键事件总数
     BTN_NONE_PRESS          // no event, 没有事件发生
 } ButtonEvent;
 
+// 是否可能越过第 2 级长按阈值（需要时序配置且允许多级）
+#define BTN_HAS_LONG_STAGES (BUTTON_ENABLE_LONG_PRESS && BUTTON_ENABLE_PROFILE && BUTTON_LONG_STAGE_MAX > 1)
+
+// 编译进来的事件（第 n 位对应事件 n），被裁剪的事件既不产生也不能注册回调
+#define BTN_EVENT_MASK  ((1u << BTN_PRESS_DOWN) | (1u << BTN_PRESS_UP) | (1u << BTN_SINGLE_CLICK) | \
+                         (BUTTON_ENABLE_MULTI_CLICK ? (1u << BTN_PRESS_REPEAT) | (1u << BTN_DOUBLE_CLICK) : 0u) | \
+                         (BUTTON_ENABLE_LONG_PRESS ? (1u << BTN_LONG_PRESS_START) : 0u) | \
+                         (BTN_HAS_LONG_STAGES ? (1u << BTN_LONG_PRESS_STAGE) : 0u) | \
+                         (BUTTON_ENABLE_LONG_PRESS && BUTTON_ENABLE_LONG_HOLD ? (1u << BTN_LONG_PRESS_HOLD) : 0u))
+
+// 事件在回调数组中的下标：排在它前面的已编译事件个数，回调数组只为编译进来的事件保留槽位
+#define BTN_BIT_COUNT8(m)   (((m) & 1u) + (((m) >> 1) & 1u) + (((m) >> 2) & 1u) + (((m) >> 3) & 1u) + \
+                             (((m) >> 4) & 1u) + (((m) >> 5) & 1u) + (((m) >> 6) & 1u) + (((m) >> 7) & 1u))
+#define BTN_CB_COUNT        BTN_BIT_COUNT8(BTN_EVENT_MASK)
+#define BTN_CB_SLOT(ev)     (BTN_CB_COUNT == BTN_EVENT_COUNT ? (unsigned)(ev) : \
+                             BTN_BIT_COUNT8(BTN_EVENT_MASK & ((1u << (ev)) - 1u)))
+
 
 // Button state machine states
 typedef enum {
@@ -62,33 +104,285 @@ typedef enum {
     BTN_STATE_LONG_HOLD     // long press hold state, 长按状态，表示按键处于长按状态
 } ButtonState;
 
+// Button timing profile
+// 按键时序配置，由调用者分配（通常为 const 全局变量），多个按键可共用同一份配置
+typedef struct {
+    uint32_t long_ticks[BUTTON_LONG_STAGE_MAX];  ///< 各级长按阈值（节拍数），严格递增
+    uint8_t  long_stages;                        ///< 有效级数（1 ~ BUTTON_LONG_STAGE_MAX）
+    uint32_t click_ticks;                        ///< 松开后等待再次按下的窗口（双击窗口），超时即判定单击/双击；0 表示 SHORT_TICKS
+    uint32_t repeat_press_ticks;                 ///< 连击时单次按下允许的最长时间，超过则按普通按下处理；0 表示 SHORT_TICKS
+} ButtonProfile;
+
 
+#if !BUTTON_LAYOUT_SPLIT
 // Button structure
 // 按键结构体定义
 struct _Button {
-    uint16_t ticks;                     ///< 节拍计数器，用于记录当前状态下持续的时间（单位为扫描周期）
+    uint32_t state_tick;                ///< 进入当前状态时的全局节拍计数，持续时间 = 当前节拍 - state_tick（取模运算，不会溢出）
 
-    uint8_t  repeat : 4;                ///< 重复次数计数器，占 4 位（0~15），用于识别连按/双击等操作
+#if BUTTON_ENABLE_MULTI_CLICK
+    uint8_t  repeat BTN_BITS(4);        ///< 重复次数计数器，占 4 位（0~15），用于识别连按/双击等操作
+#endif
+
+    uint8_t  event BTN_BITS(4);         ///< 当前按键事件，占 4 位（0~15），例如按下、释放、单击等，用于状态传递
 
-    uint8_t  event : 4;                 ///< 当前按键事件，占 4 位（0~15），例如按下、释放、单击等，用于状态传递
+    uint8_t  state BTN_BITS(3);         ///< 按键状态机的状态，占 3 位（0~7），如空闲、按下、释放、长按等状态
 
-    uint8_t  state : 3;                 ///< 按键状态机的状态，占 3 位（0~7），如空闲、按下、释放、长按等状态
+    uint8_t  debounce_cnt BTN_BITS(3);  ///< 去抖动计数器，占 3 位（0~7），用于过滤按键抖动，确保状态稳定再切换
 
-    uint8_t  debounce_cnt : 3;          ///< 去抖动计数器，占 3 位（0~7），用于过滤按键抖动，确保状态稳定再切换
+    uint8_t  active_level BTN_BITS(1);  ///< 按键有效电平，占 1 位（0 或 1），表示按键按下时的 GPIO 有效电平
 
-    uint8_t  active_level : 1;          ///< 按键有效电平，占 1 位（0 或 1），表示按键按下时的 GPIO 有效电平
+    uint8_t  button_level BTN_BITS(1);  ///< 当前读取的按键电平，占 1 位（0 或 1），表示实际读取到的电平状态
 
-    uint8_t  button_level : 1;          ///< 当前读取的按键电平，占 1 位（0 或 1），表示实际读取到的电平状态
+#if BUTTON_ENABLE_LONG_PRESS
+    uint8_t  long_stage BTN_BITS(4);    ///< 本次按住已越过的长按级数，占 4 位（0~15）
+#endif
 
     uint8_t  button_id;                 ///< 按键标识符，用于区分多个按键或在 HAL 层回调中传递参数
 
+    uint8_t  pending_op;                ///< 待应用的启动/停止请求（回调中或并发模式下登记），后登记者生效
+
+    uint8_t  queued;                    ///< 是否已在待应用链表中，避免重复入队
+
+    uint8_t  active;                    ///< 是否已在工作链表中
+
+    uint32_t duration;                  ///< 最近一次 BTN_PRESS_UP 的按下时长或 BTN_PRESS_REPEAT 的间隔（节拍数）
+
     uint8_t  (*hal_button_level)(uint8_t button_id);  ///< HAL 层函数指针，根据按键 ID 读取 GPIO 电平
 
-    BtnCallback cb[BTN_EVENT_COUNT];    ///< 回调函数数组，对应不同事件（如按下、释放、单击、双击、长按等）的处理函数
+#if BUTTON_ENABLE_MMIO
+    const volatile ButtonInputWord* input_reg;  ///< 内存映射输入字，非 NULL 时直接加载该字而不调用 HAL 函数
+    ButtonInputWord input_mask;         ///< 输入字中属于本按键的位，任一位为 1 即为电平 1
+#endif
+
+#if BUTTON_ENABLE_PROFILE
+    const ButtonProfile* profile;       ///< 时序配置，NULL 表示使用默认配置（单级长按，阈值 LONG_TICKS）
+#endif
+
+#if BUTTON_ENABLE_CALLBACKS
+    BtnCallback cb[BTN_CB_COUNT];       ///< 回调函数数组，按 BTN_CB_SLOT(事件) 索引，只为编译进来的事件保留槽位
+#endif
 
     Button* next;                       ///< 指向下一个按键结构体指针，用于将多个按键结构组织成单向链表
+
+    Button*  pending_next;              ///< 待应用配置变更链表指针（由 button_ticks() 在遍历结束后处理）
 };
 
+#if BUTTON_ENABLE_COMPACT
+// Traversal table slot
+// 连续遍历表的表项，数组由调用者提供，按 (hal_button_level, button_id) 排序
+typedef struct {
+    Button*  handle;                    ///< 对应的按键
+    uint8_t  (*hal_button_level)(uint8_t button_id);  ///< HAL 读取函数副本，扫描时无需访问按键结构体即可读取电平
+#if BUTTON_ENABLE_MMIO
+    const volatile ButtonInputWord* input_reg;  ///< 内存映射输入字副本
+    ButtonInputWord input_mask;         ///< 输入位掩码副本
+#endif
+    uint8_t  button_id;                 ///< 按键标识符副本
+} ButtonSlot;
+#endif
+
+#else /* BUTTON_LAYOUT_SPLIT */
+// Hot per-tick state
+// 分离布局：每个节拍都要访问的状态集中在遍历表项中（连续数组），回调和配置留在冷数据 Button 中
+typedef struct {
+    uint8_t  (*hal_button_level)(uint8_t button_id);  ///< HAL 读取函数副本
+
+#if BUTTON_ENABLE_MMIO
+    const volatile ButtonInputWord* input_reg;  ///< 内存映射输入字副本
+    ButtonInputWord input_mask;         ///< 输入位掩码副本
+#endif
+
+    Button*  handle;                    ///< 对应的按键（冷数据，仅在产生事件时访问）
+
+    uint32_t state_tick;                ///< 进入当前状态时的全局节拍计数，持续时间 = 当前节拍 - state_tick（取模运算，不会溢出）
+
+#if BUTTON_ENABLE_MULTI_CLICK
+    uint8_t  repeat BTN_BITS(4);        ///< 重复次数计数器，占 4 位（0~15）
+#endif
+
+    uint8_t  event BTN_BITS(4);         ///< 当前按键事件，占 4 位（0~15）
+
+    uint8_t  state BTN_BITS(3);         ///< 按键状态机的状态，占 3 位（0~7）
+
+    uint8_t  debounce_cnt BTN_BITS(3);  ///< 去抖动计数器，占 3 位（0~7）
+
+    uint8_t  active_level BTN_BITS(1);  ///< 按键有效电平副本
+
+    uint8_t  button_level BTN_BITS(1);  ///< 当前去抖后的按键电平
+
+#if BUTTON_ENABLE_LONG_PRESS
+    uint8_t  long_stage BTN_BITS(4);    ///< 本次按住已越过的长按级数
+#endif
+
+    uint8_t  button_id;                 ///< 按键标识符副本
+} ButtonSlot;
+
+// Button structure (cold record)
+// 按键结构体：分离布局下只保存配置、回调和登记信息，不参与逐节拍扫描
+struct _Button {
+    ButtonSlot* slot;                   ///< 遍历表中的热数据，未启动时为 NULL
+
+    uint8_t  (*hal_button_level)(uint8_t button_id);  ///< HAL 层函数指针，根据按键 ID 读取 GPIO 电平
+
+#if BUTTON_ENABLE_MMIO
+    const volatile ButtonInputWord* input_reg;  ///< 内存映射输入字，启动时复制到表项中
+    ButtonInputWord input_mask;         ///< 输入字中属于本按键的位
+#endif
+
+    uint8_t  button_id;                 ///< 按键标识符，用于区分多个按键或在 HAL 层回调中传递参数
+
+    uint8_t  active_level;              ///< 按键有效电平，启动时复制到热数据中
+
+    uint8_t  pending_op;                ///< 待应用的启动/停止请求（回调中或并发模式下登记），后登记者生效
+
+    uint8_t  queued;                    ///< 是否已在待应用链表中，避免重复入队
+
+    uint8_t  active;                    ///< 是否已在工作链表中
+
+    uint32_t duration;                  ///< 最近一次 BTN_PRESS_UP 的按下时长或 BTN_PRESS_REPEAT 的间隔（节拍数）
+
+#if BUTTON_ENABLE_PROFILE
+    const ButtonProfile* profile;       ///< 时序配置，NULL 表示使用默认配置；仅在按键非空闲时访问
+#endif
+
+#if BUTTON_ENABLE_CALLBACKS
+    BtnCallback cb[BTN_CB_COUNT];       ///< 回调函数数组，按 BTN_CB_SLOT(事件) 索引
+#endif
+
+    Button* next;                       ///< 指向下一个按键结构体指针，用于将多个按键结构组织成单向链表
+
+    Button*  pending_next;              ///< 待应用配置变更链表指针（由 button_ticks() 在遍历结束后处理）
+};
+#endif
+
+#if BUTTON_ENABLE_TWO_PHASE
+// Input sampler
+// 采样函数：为遍历表的每个表项读取电平，levels[i] 对应 slots[i]（表项按 HAL 函数和 button_id 排序，同一端口的按键相邻）
+typedef void (*ButtonSampler)(uint8_t* levels, const ButtonSlot* slots, uint16_t count);
+#endif
+
+#if BUTTON_ENABLE_BUDGET_SCAN
+// Budgeted scan clock
+// 时间预算使用的时钟：返回单调递增的计数（纳秒、CPU 周期等任意单位，允许回绕），与 max_time 单位一致
+typedef uint32_t (*ButtonClock)(void);
+
+// Budgeted scan statistics
+// 增量扫描统计，由 button_scan_stats() 填写
+typedef struct {
+    uint32_t rounds;                    ///< 已完成的完整扫描轮数（每轮每个按键被服务一次）
+    uint32_t round_ticks;               ///< 上一轮占用的节拍数，即每个按键的服务间隔；1 表示每节拍都扫完全部按键
+    uint32_t round_ticks_max;           ///< 观测到的最大服务间隔（节拍）
+    uint32_t lag;                       ///< 当前轮已进行的节拍数，尚未扫到的按键至少已等待这么久
+    uint16_t position;                  ///< 当前轮已服务的按键数
+} ButtonScanStats;
+#endif
+
+#if BUTTON_ENABLE_ENCODER
+typedef struct _ButtonEncoder ButtonEncoder;
+
+// Encoder detent callback
+// 编码器定位格回调：step 为 +1（A 相超前，记为顺时针）或 -1
+typedef void (*EncoderCallback)(ButtonEncoder* encoder, int8_t step);
+
+// Quadrature rotary encoder
+// 正交旋转编码器：A/B 两相按通道 id 通过与按键相同签名的 HAL 函数读取，在 button_ticks() 中与按键一起采样
+struct _ButtonEncoder {
+    uint8_t  (*hal_level)(uint8_t id);  ///< 读取通道电平的函数指针
+    EncoderCallback cb;                 ///< 定位格回调，NULL 表示只轮询位置
+    ButtonEncoder* next;                ///< 编码器链表指针
+    int32_t  position;                  ///< 累计定位格数（顺时针为正）
+    uint32_t detent_tick;               ///< 最近一次定位格的节拍
+    uint16_t interval;                  ///< 相邻定位格间隔的平滑值（节拍），用于估算转速；0 表示尚无估计
+    uint8_t  a_id;                      ///< A 相通道 id
+    uint8_t  b_id;                      ///< B 相通道 id
+    uint8_t  steps_per_detent;          ///< 每个定位格的相位跳变数（常见为 4，半步型为 2）
+    uint8_t  ab;                        ///< 上一次采样的相位，A 为高位
+    int8_t   sub;                       ///< 当前定位格内累计的跳变数
+    int8_t   dir;                       ///< 最近一次定位格的方向，0 表示尚未转动
+    uint8_t  active;                    ///< 0: 未注册，1: 正在扫描，2: 已停止、等待在节拍中摘除
+#if BUTTON_ENABLE_TWO_PHASE
+    uint8_t  sample;                    ///< 两阶段节拍采样阶段读取的相位（占用结构体尾部填充）
+#endif
+};
+#endif
+
+#if BUTTON_ENABLE_SWITCH
+typedef struct _ButtonSwitch ButtonSwitch;
+
+// Switch transition callback
+// 开关状态变化回调：on 为 1 表示接通（电平等于有效电平），0 表示断开
+typedef void (*SwitchCallback)(ButtonSwitch* sw, uint8_t on);
+
+// Debounce-only switch
+// 开关：只去抖并报告通断变化，在 button_ticks() 中与按键一起采样
+struct _ButtonSwitch {
+    uint8_t  (*hal_level)(uint8_t id);  ///< 读取开关电平的函数指针（与按键相同的 HAL 签名）
+    SwitchCallback cb;                  ///< 状态变化回调，NULL 表示只轮询
+    ButtonSwitch* next;                 ///< 开关链表指针
+    uint8_t  switch_id;                 ///< 开关 id，传给 HAL 函数
+    uint8_t  active_level;              ///< 接通时的电平
+    uint8_t  level;                     ///< 去抖后的电平
+    uint8_t  debounce_cnt;              ///< 去抖计数
+    uint8_t  active;                    ///< 0: 未注册，1: 正在扫描，2: 已停止、等待在节拍中摘除
+#if BUTTON_ENABLE_TWO_PHASE
+    uint8_t  sample;                    ///< 两阶段节拍采样阶段读取的电平（占用结构体尾部填充）
+#endif
+};
+#endif
+
+#if BUTTON_ENABLE_LOGIC
+// Physical input of logical buttons
+// 逻辑按键使用的物理输入，在输入表中的下标即表达式中的位号
+typedef struct {
+    uint8_t  (*hal_level)(uint8_t id);  ///< 读取电平的函数指针（与按键相同的 HAL 签名）
+    uint8_t  input_id;                  ///< 传给 HAL 函数的 id
+    uint8_t  active_level;              ///< 有效（按下）时的电平
+} ButtonInput;
+
+// Logical button expression
+// 逻辑表达式（按位对应输入表下标，位为 1 表示该输入有效）：all 全部有效，且 none 全部无效，且 any 至少一个有效（any 为 0 时不要求）
+typedef struct {
+    uint32_t all;                       ///< 必须全部有效的输入
+    uint32_t none;                      ///< 必须全部无效的输入
+    uint32_t any;                       ///< 至少一个有效的输入，0 表示不要求
+} ButtonLogic;
+#endif
+
+#if BUTTON_ENABLE_POOL
+// Button pool
+// 按键池，存储空间由调用者提供（例如 static Button storage[64]）
+typedef struct {
+    Button*  storage;                   ///< 调用者提供的按键数组
+    uint16_t capacity;                  ///< 数组容量
+    uint16_t used;                      ///< 高水位：[0, used) 的槽位至少被分配过一次，活动按键都位于此区间
+    uint16_t live;                      ///< 当前已分配的按键数
+    Button*  free_list;                 ///< 已释放槽位组成的链表（通过 next 链接），后进先出以复用热缓存
+} ButtonPool;
+#endif
+
+// Queued event record
+// 事件记录，由 button_ticks() 写入事件环形缓冲区
+typedef struct {
+    Button*  button;                    ///< 产生事件的按键
+    uint32_t tick;                      ///< 事件产生时的全局节拍计数（button_ticks() 调用次数）
+    uint32_t duration;                  ///< BTN_PRESS_UP: 按下时长；BTN_PRESS_REPEAT: 与上次松开的间隔；其他事件为 0
+    uint8_t  event;                     ///< 事件类型（ButtonEvent）
+    uint8_t  repeat;                    ///< 事件产生时的重复按下次数
+} ButtonEventRecord;
+
+// Batched event sink
+// 批量事件处理函数：每个节拍（或数组写满时）调用一次，records 按产生顺序排列，仅在调用期间有效
+typedef void (*ButtonBatchSink)(const ButtonEventRecord* records, int count);
+
+// Event ring subscriber
+// 事件订阅者，每个订阅者拥有独立的读游标，由调用者分配
+typedef struct {
+    uint32_t cursor;                    ///< 下一条待读事件的序号
+    uint32_t lag_max;                   ///< 观测到的最大落后条数，用于发现慢消费者
+    uint32_t overruns;                  ///< 因落后过多被覆盖而丢失的事件数
+} ButtonSubscriber;
+
 
 
 #ifdef __cplusplus
@@ -97,17 +391,113 @@ extern "C" {
 
 // Public API functions
 void button_init(Button* handle, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t button_id);
+#if BUTTON_ENABLE_MMIO
+void button_init_mmio(Button* handle, const volatile ButtonInputWord* reg, ButtonInputWord mask,
+                      uint8_t active_level, uint8_t button_id);
+#endif
+#if BUTTON_ENABLE_CALLBACKS
 void button_attach(Button* handle, ButtonEvent event, BtnCallback cb);
 void button_detach(Button* handle, ButtonEvent event);
+#endif
 ButtonEvent button_get_event(Button* handle);
 int  button_start(Button* handle);
 void button_stop(Button* handle);
 void button_ticks(void);
 
+// Batch registration
+int button_init_batch(Button* handles, uint16_t count, uint8_t(*pin_level)(uint8_t),
+                      uint8_t active_level, uint8_t first_id, const BtnCallback* cb);
+int button_start_batch(Button* handles, uint16_t count);
+int button_stop_batch(Button* handles, uint16_t count);
+
 // Utility functions
 uint8_t button_get_repeat_count(Button* handle);
 void button_reset(Button* handle);
 int button_is_pressed(Button* handle);
+uint32_t button_get_tick(void);
+int button_is_active(Button* handle);
+
+// Timing profile and hold duration
+#if BUTTON_ENABLE_PROFILE
+int button_set_profile(Button* handle, const ButtonProfile* profile);
+#endif
+uint32_t button_get_hold_ticks(Button* handle);
+uint8_t button_get_long_stage(Button* handle);
+uint32_t button_get_duration(Button* handle);
+
+#if BUTTON_ENABLE_COMPACT
+// Contiguous traversal table
+int button_compact(ButtonSlot* slots, uint16_t capacity);
+#endif
+
+#if BUTTON_ENABLE_TWO_PHASE
+// Two-phase tick: sample all inputs, then run all state machines
+int button_set_sampler(uint8_t* levels, uint16_t capacity, ButtonSampler sampler);
+#endif
+
+#if BUTTON_ENABLE_BUDGET_SCAN
+// Time-budgeted incremental scanning
+int  button_ticks_budget(uint16_t max_buttons, ButtonClock clock, uint32_t max_time);
+void button_scan_stats(ButtonScanStats* stats);
+#endif
+
+#if BUTTON_ENABLE_ENCODER
+// Quadrature rotary encoder
+void button_encoder_init(ButtonEncoder* encoder, uint8_t(*pin_level)(uint8_t), uint8_t a_id, uint8_t b_id, uint8_t steps_per_detent);
+void button_encoder_attach(ButtonEncoder* encoder, EncoderCallback cb);
+int  button_encoder_start(ButtonEncoder* encoder);
+void button_encoder_stop(ButtonEncoder* encoder);
+int32_t button_encoder_get_position(ButtonEncoder* encoder);
+int32_t button_encoder_get_velocity(ButtonEncoder* encoder);
+#endif
+
+#if BUTTON_ENABLE_SWITCH
+// Debounce-only switches
+void button_switch_init(ButtonSwitch* sw, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t switch_id);
+void button_switch_attach(ButtonSwitch* sw, SwitchCallback cb);
+int  button_switch_start(ButtonSwitch* sw);
+void button_switch_stop(ButtonSwitch* sw);
+int  button_switch_is_on(ButtonSwitch* sw);
+#endif
+
+#if BUTTON_ENABLE_LOGIC
+// Logical buttons over shared physical inputs
+int button_logic_init(const ButtonInput* inputs, uint8_t input_count, const ButtonLogic* logic, uint8_t logic_count);
+uint8_t button_logic_level(uint8_t logic_id);
+uint32_t button_logic_inputs(void);
+#endif
+
+#if BUTTON_ENABLE_POOL
+// Static pool allocation
+int button_pool_init(ButtonPool* pool, Button* storage, uint16_t capacity);
+Button* button_create(ButtonPool* pool, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t button_id);
+int button_destroy(ButtonPool* pool, Button* handle);
+#endif
+
+#if BUTTON_EVENT_RING_SIZE
+// Event queue
+int button_event_read(ButtonEventRecord* out, int max);
+uint32_t button_event_dropped(void);
+
+// Multi-consumer fan-out
+void button_subscriber_init(ButtonSubscriber* sub);
+const ButtonEventRecord* button_subscriber_peek(ButtonSubscriber* sub, int* count);
+int  button_subscriber_commit(ButtonSubscriber* sub, int n);
+uint32_t button_subscriber_lag(const ButtonSubscriber* sub);
+#endif
+
+#if BUTTON_EVENT_BATCH_SIZE
+// Batched event delivery
+void button_set_batch_sink(ButtonBatchSink sink);
+#endif
+
+#if BUTTON_ENABLE_EVENTFD
+// eventfd notification (Linux)
+int  button_eventfd_open(void);
+void button_eventfd_close(void);
+int  button_eventfd(void);
+int  button_eventfd_drain(ButtonEventRecord* out, int max);
+#endif
 
 #ifdef __cplusplus
 }
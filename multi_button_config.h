@@ -0,0 +1,222 @@
+/*
+ * MultiButton 配置文件
+ * 所有选项都可以直接在此修改，或在编译命令中用 -D 覆盖（例如 -DBUTTON_ENABLE_MULTI_CLICK=0）。
+ */
+
+#ifndef _MULTI_BUTTON_CONFIG_H_
+#define _MULTI_BUTTON_CONFIG_H_
+
+/*------------------------------ 时序 ------------------------------*/
+
+/* 定义定时器中断的时间间隔为5毫秒。这个间隔决定了系统的时间粒度，通常用于计时和控制事件的触发频率。 */
+#ifndef TICKS_INTERVAL
+#define TICKS_INTERVAL          5    // ms - 定时器中断的间隔时间（5毫秒）
+#endif
+
+/* 去抖时间。按键状态变化时，必须连续 DEBOUNCE_TICKS 个节拍电平稳定才会认为状态有效，
+ * 用于避免按键物理弹跳引起的多次触发。默认 15ms / 5ms = 3 个节拍。
+ */
+#ifndef DEBOUNCE_TIME_MS
+#define DEBOUNCE_TIME_MS        15   // ms - 去抖时间
+#endif
+
+#ifndef DEBOUNCE_TICKS
+#define DEBOUNCE_TICKS          (DEBOUNCE_TIME_MS / TICKS_INTERVAL)  // 最大为7（1 ~ 7）- 去抖动过滤深度
+#endif
+
+/* 短按时间阈值（双击窗口、连击按下上限的默认值）。
+ *  例如，TICKS_INTERVAL = 5，则 SHORT_TICKS = 300 / 5 = 60，表示短按的阈值为60个定时器中断。
+ */
+#ifndef SHORT_PRESS_TIME_MS
+#define SHORT_PRESS_TIME_MS     300  // ms - 短按时间阈值
+#endif
+
+#define SHORT_TICKS             (SHORT_PRESS_TIME_MS / TICKS_INTERVAL)   // 短按阈值
+
+/* 长按时间阈值（默认时序配置的第 1 级长按）。
+ *  例如，TICKS_INTERVAL = 5，则 LONG_TICKS = 1000 / 5 = 200，表示长按的阈值为200个定时器中断。
+ */
+#ifndef LONG_PRESS_TIME_MS
+#define LONG_PRESS_TIME_MS      1000 // ms - 长按时间阈值
+#endif
+
+#define LONG_TICKS              (LONG_PRESS_TIME_MS / TICKS_INTERVAL)  // 长按阈值
+
+/* 定义按键重复按下的最大次数为15。用于在按键被持续按住时，控制事件触发的最大次数，防止触发无限循环事件。 */
+#ifndef PRESS_REPEAT_MAX_NUM
+#define PRESS_REPEAT_MAX_NUM    15   // 最大重复计数值（1 ~ 15）
+#endif
+
+/*---------------------------- 事件裁剪 ----------------------------*/
+
+/* 事件回调。关闭后 Button 中不再包含回调函数数组，也不提供 button_attach()/button_detach()，
+ * 应用在每次 button_ticks() 之后用 button_get_event() 轮询，或通过事件环形缓冲区读取事件。
+ */
+#ifndef BUTTON_ENABLE_CALLBACKS
+#define BUTTON_ENABLE_CALLBACKS 1
+#endif
+
+/* 连击（双击/多击）识别。关闭后去掉 RELEASE/REPEAT 状态、重复计数和 BTN_PRESS_REPEAT/BTN_DOUBLE_CLICK 事件，
+ * 松开时立即产生 BTN_SINGLE_CLICK，无需等待双击窗口。
+ */
+#ifndef BUTTON_ENABLE_MULTI_CLICK
+#define BUTTON_ENABLE_MULTI_CLICK 1
+#endif
+
+/* 长按识别。关闭后去掉 LONG_HOLD 状态、长按级数和 BTN_LONG_PRESS_START/HOLD/STAGE 事件，按住多久都按普通按下处理。 */
+#ifndef BUTTON_ENABLE_LONG_PRESS
+#define BUTTON_ENABLE_LONG_PRESS 1
+#endif
+
+/* 长按保持事件。关闭后长按期间不再每个节拍产生 BTN_LONG_PRESS_HOLD（长按开始与多级长按事件不受影响）。 */
+#ifndef BUTTON_ENABLE_LONG_HOLD
+#define BUTTON_ENABLE_LONG_HOLD 1
+#endif
+
+/*---------------------------- 可选功能 ----------------------------*/
+
+/* 事件通知文件描述符（Linux eventfd）。开启后库会把事件写入内部环形缓冲区，并在有新事件的节拍末尾
+ * 最多写一次 eventfd，消费者线程可以阻塞在 epoll/poll 上，直到真正有事件需要处理。仅适用于 Linux。
+ */
+#ifndef BUTTON_ENABLE_EVENTFD
+#define BUTTON_ENABLE_EVENTFD   0
+#endif
+
+/* 事件环形缓冲区容量（必须为 2 的幂，0 表示关闭）。开启 eventfd 时默认 64 条。
+ * 缓冲区满时覆盖最旧的事件，消费者通过 button_event_dropped() 获知丢失数量。
+ * 并发模式或 eventfd 下生产者可能与读取同时运行，最旧的一个槽位随时可能被改写，可用容量为 BUTTON_EVENT_RING_SIZE - 1。
+ */
+#ifndef BUTTON_EVENT_RING_SIZE
+#if BUTTON_ENABLE_EVENTFD
+#define BUTTON_EVENT_RING_SIZE  64
+#else
+#define BUTTON_EVENT_RING_SIZE  0
+#endif
+#endif
+
+/* 批量事件交付容量（条，0 表示关闭）。开启后 button_ticks() 把本节拍产生的事件依次写入内部数组，
+ * 遍历结束时一次性交给 button_set_batch_sink() 注册的处理函数；数组写满时提前交付一批，不丢事件。
+ */
+#ifndef BUTTON_EVENT_BATCH_SIZE
+#define BUTTON_EVENT_BATCH_SIZE 0
+#endif
+
+/* 并发配置模式。开启后 button_attach()/button_detach() 以原子方式写回调槽位，
+ * button_start()/button_stop() 只登记变更，由 button_ticks() 在节拍边界统一应用，
+ * 因此其他线程可以在定时器线程运行 button_ticks() 的同时安全地修改配置，节拍路径上不加锁。需要 GCC/Clang。
+ */
+#ifndef BUTTON_ENABLE_CONCURRENT
+#define BUTTON_ENABLE_CONCURRENT 0
+#endif
+
+/* 静态按键池。开启后可通过 button_create()/button_destroy() 在调用者提供的一块缓冲区中动态创建按键，
+ * O(1) 分配/释放，初始化之后不使用堆内存。默认关闭。
+ */
+#ifndef BUTTON_ENABLE_POOL
+#define BUTTON_ENABLE_POOL      0
+#endif
+
+/* 连续遍历表。开启后可调用 button_compact() 把已注册按键整理为一张按 HAL 函数和 button_id 排序的连续数组，
+ * button_ticks() 顺序扫描该数组而不是沿链表跳转；之后的启动/停止会自动保持数组有序。
+ * 默认关闭；分离布局和两阶段节拍依赖遍历表，开启二者之一时随之开启。
+ */
+#ifndef BUTTON_ENABLE_COMPACT
+#define BUTTON_ENABLE_COMPACT   (BUTTON_LAYOUT_SPLIT || BUTTON_ENABLE_TWO_PHASE)
+#endif
+
+/* 两阶段节拍。开启后 button_ticks() 先扫描一遍遍历表，把所有按键的电平读入采样缓冲区，再统一运行状态机：
+ * 同一节拍内所有按键使用同一时刻的电平快照（便于组合键判断），采样阶段也可以交给用户的采样函数按端口批量读取或从 DMA 缓冲区解码。
+ * 编码器相位和开关电平在同一采样阶段读取，属于同一份快照；逻辑按键的物理输入在遍历表中的逻辑按键被采样时读取。
+ * 需要连续遍历表，未设置遍历表或采样缓冲区时仍逐个读取。
+ */
+#ifndef BUTTON_ENABLE_TWO_PHASE
+#define BUTTON_ENABLE_TWO_PHASE 0
+#endif
+
+/* 限时增量扫描。开启后可用 button_ticks_budget() 代替 button_ticks()：每次调用只扫描不超过给定按键数或时间预算的一段，
+ * 下次调用从停下的位置继续（轮转），用于按键数量极大、一个节拍内扫不完全部按键的场合。
+ * 计时以节拍时间戳为准，服务间隔变长不影响长按/双击等时间判断；button_scan_stats() 报告覆盖一轮所需的节拍数。
+ */
+#ifndef BUTTON_ENABLE_BUDGET_SCAN
+#define BUTTON_ENABLE_BUDGET_SCAN 0
+#endif
+
+/* 正交旋转编码器。开启后可用 button_encoder_start() 注册编码器，A/B 两相使用与按键相同的 HAL 读取函数，
+ * 在 button_ticks() 的同一次调用中采样并查表解码，产生定位格回调、累计位置和转速估计，不需要额外的定时器。
+ * 超过 ENCODER_IDLE_TIME_MS 没有转动时转速归零，下一次转动重新开始估计。
+ */
+#ifndef BUTTON_ENABLE_ENCODER
+#define BUTTON_ENABLE_ENCODER   0
+#endif
+
+#ifndef ENCODER_IDLE_TIME_MS
+#define ENCODER_IDLE_TIME_MS    500  // ms - 转速估计的静止超时
+#endif
+
+#define ENCODER_IDLE_TICKS      (ENCODER_IDLE_TIME_MS / TICKS_INTERVAL)  // 静止超时节拍数
+
+/* 开关模式。开启后可用 button_switch_start() 注册自锁开关、限位开关等只关心通断的输入：
+ * 每节拍只做与按键相同的去抖，稳定后产生接通/断开回调，不运行单击、连击、长按状态机，结构体也远小于 Button。
+ */
+#ifndef BUTTON_ENABLE_SWITCH
+#define BUTTON_ENABLE_SWITCH    0
+#endif
+
+/* 逻辑按键。开启后可用 button_logic_init() 登记一组物理输入和若干逻辑表达式（如 "A 且非 B"、"组内任一"），
+ * 物理输入每节拍只读取一次；以 button_logic_level() 作为 HAL 函数、表达式序号作为 button_id 初始化按键，
+ * 每个逻辑按键拥有独立的状态机而不重复读取 GPIO。物理输入最多 32 个。
+ */
+#ifndef BUTTON_ENABLE_LOGIC
+#define BUTTON_ENABLE_LOGIC     0
+#endif
+
+/* 内存映射输入。开启后可用 button_init_mmio() 把按键绑定到一个输入字（GPIO 输入数据寄存器、DMA 缓冲区或普通变量）
+ * 的某些位上，扫描时直接加载该字并按掩码取位，不经过 HAL 函数指针；同一个字上相邻的按键每节拍只加载一次。
+ * 每个按键（及遍历表项）多占一个指针和一个掩码。BUTTON_MMIO_WORD 为输入字的类型，应与寄存器的访问宽度一致。
+ */
+#ifndef BUTTON_ENABLE_MMIO
+#define BUTTON_ENABLE_MMIO      0
+#endif
+
+#ifndef BUTTON_MMIO_WORD
+#define BUTTON_MMIO_WORD        uint32_t
+#endif
+
+/* 冷热分离布局。开启后每节拍访问的状态（计数器、状态机、去抖、电平）集中存放在 button_compact() 提供的
+ * 连续遍历表中，Button 只保留回调和配置，扫描大量按键时缓存未命中显著减少。
+ * 未调用 button_compact() 时使用内置的 BUTTON_SPLIT_DEFAULT_SLOTS 项遍历表，更多按键需先调用 button_compact()
+ * 提供更大的遍历表（内置表满时 button_start() 返回 -3）；按键停止时其热数据随表项释放，重新启动时从空闲状态开始。
+ */
+#ifndef BUTTON_LAYOUT_SPLIT
+#define BUTTON_LAYOUT_SPLIT     0
+#endif
+
+#ifndef BUTTON_SPLIT_DEFAULT_SLOTS
+#define BUTTON_SPLIT_DEFAULT_SLOTS  8   // 分离布局内置遍历表的项数，0 表示必须调用 button_compact()
+#endif
+
+/* 快速字段布局。默认把 repeat/event/state/debounce_cnt/active_level/button_level 压缩为位域以节省内存，
+ * 每次更新都是带掩码的读-改-写；开启后每个字段独占一个字节（每个按键多占约 4 字节），
+ * 状态机更新只需单条字节存储，其他线程也可以原子地按字节读取这些字段。
+ * 建议与 BUTTON_LAYOUT_SPLIT 一起使用：默认布局下 Button 变大，是否更快取决于结构体跨缓存行的情况，可能反而变慢。
+ */
+#ifndef BUTTON_LAYOUT_FAST
+#define BUTTON_LAYOUT_FAST      0
+#endif
+
+/* 多级长按的最大级数。按键时序配置（ButtonProfile）中每一级在按住时长首次超过其阈值时产生一次事件：
+ * 第 1 级产生 BTN_LONG_PRESS_START，其后各级产生 BTN_LONG_PRESS_STAGE，无需在用户代码中统计 BTN_LONG_PRESS_HOLD。
+ */
+#ifndef BUTTON_LONG_STAGE_MAX
+#define BUTTON_LONG_STAGE_MAX   4
+#endif
+
+/* 按键时序配置，默认关闭。关闭时 Button 中不再包含 profile 指针（64 位平台省 8 字节），也不提供 button_set_profile()，
+ * 所有按键使用默认时序（单级长按 LONG_TICKS，双击窗口与连击按下上限 SHORT_TICKS），阈值为编译期常量；
+ * 同时去掉 BTN_LONG_PRESS_STAGE 事件及其回调槽位。BUTTON_LONG_STAGE_MAX 为 1 时同样去掉该事件。
+ */
+#ifndef BUTTON_ENABLE_PROFILE
+#define BUTTON_ENABLE_PROFILE   0
+#endif
+
+#endif
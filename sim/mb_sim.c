@@ -0,0 +1,359 @@
+/*
+ * MultiButton 仿真库：虚拟时钟 + 虚拟 GPIO
+ * 虚拟时钟即 button_ticks() 的调用次数，不调用 usleep()，单个按键每秒可仿真数千万个节拍。
+ */
+
+#include "mb_sim.h"
+
+static Button   sim_buttons[MB_SIM_MAX_BUTTONS];  // 仿真按键存储
+static uint8_t  sim_count = 0;                    // 已添加的仿真按键数
+static uint8_t  sim_gpio[256];                    // 虚拟 GPIO 电平，按 button_id 索引
+static uint8_t  sim_active[256];                  // 各按键的有效电平，用于把"按下/松开"换算为电平
+static uint32_t sim_base = 0;                     // mb_sim_reset() 时的全局节拍，虚拟时钟从此处起算
+
+static MbSimEvent sim_events[MB_SIM_MAX_EVENTS];  // 事件捕获缓冲区
+static int      sim_event_count = 0;              // 已捕获事件数
+static uint32_t sim_event_lost = 0;               // 缓冲区满而丢弃的事件数
+static uint32_t sim_capture_mask = MB_SIM_CAPTURE_ALL;  // 需要捕获的事件
+
+#if BUTTON_LAYOUT_SPLIT || BUTTON_ENABLE_TWO_PHASE
+static ButtonSlot sim_slots[MB_SIM_MAX_BUTTONS];  // 分离布局下的遍历表（热数据）；两阶段节拍同样需要遍历表
+#endif
+#if BUTTON_ENABLE_TWO_PHASE
+static uint8_t  sim_levels[MB_SIM_MAX_BUTTONS];   // 两阶段节拍的采样缓冲区
+#endif
+
+/**
+  * @brief  记录一条事件
+  * @param  btn: 产生事件的按键
+  * @param  event: 事件类型
+  * @param  tick: 事件产生时的全局节拍
+  * @param  repeat: 重复按下次数
+  * @param  duration: 事件携带的时长
+  * @retval None
+  */
+static void sim_store(Button* btn, ButtonEvent event, uint32_t tick, uint8_t repeat, uint32_t duration)
+{
+    MbSimEvent* rec;
+
+    if (!(sim_capture_mask & (1u << event))) return;
+
+    if (sim_event_count >= MB_SIM_MAX_EVENTS) {
+        sim_event_lost++;
+        return;
+    }
+
+    rec = &sim_events[sim_event_count++];
+    rec->tick = tick - sim_base;
+    rec->duration = duration;
+    rec->button_id = btn->button_id;
+    rec->event = (uint8_t)event;
+    rec->repeat = repeat;
+}
+
+#if BUTTON_ENABLE_CALLBACKS
+/**
+  * @brief  在事件回调中记录一条事件
+  * @param  btn: 产生事件的按键
+  * @param  event: 事件类型
+  * @retval None
+  */
+static void sim_record(Button* btn, ButtonEvent event)
+{
+    sim_store(btn, event, button_get_tick(), button_get_repeat_count(btn),
+              (event == BTN_PRESS_UP || event == BTN_PRESS_REPEAT) ? button_get_duration(btn) : 0);
+}
+
+// 每个事件一个捕获回调（回调本身不携带事件类型）
+#define SIM_CAPTURE_CB(ev)  static void sim_on_##ev(Button* btn) { sim_record(btn, ev); }
+SIM_CAPTURE_CB(BTN_PRESS_DOWN)
+SIM_CAPTURE_CB(BTN_PRESS_UP)
+SIM_CAPTURE_CB(BTN_PRESS_REPEAT)
+SIM_CAPTURE_CB(BTN_SINGLE_CLICK)
+SIM_CAPTURE_CB(BTN_DOUBLE_CLICK)
+SIM_CAPTURE_CB(BTN_LONG_PRESS_START)
+SIM_CAPTURE_CB(BTN_LONG_PRESS_HOLD)
+SIM_CAPTURE_CB(BTN_LONG_PRESS_STAGE)
+
+static const BtnCallback sim_capture_cb[BTN_EVENT_COUNT] = {
+    [BTN_PRESS_DOWN]       = sim_on_BTN_PRESS_DOWN,
+    [BTN_PRESS_UP]         = sim_on_BTN_PRESS_UP,
+    [BTN_PRESS_REPEAT]     = sim_on_BTN_PRESS_REPEAT,
+    [BTN_SINGLE_CLICK]     = sim_on_BTN_SINGLE_CLICK,
+    [BTN_DOUBLE_CLICK]     = sim_on_BTN_DOUBLE_CLICK,
+    [BTN_LONG_PRESS_START] = sim_on_BTN_LONG_PRESS_START,
+    [BTN_LONG_PRESS_HOLD]  = sim_on_BTN_LONG_PRESS_HOLD,
+    [BTN_LONG_PRESS_STAGE] = sim_on_BTN_LONG_PRESS_STAGE,
+};
+#else
+/**
+  * @brief  批量事件处理函数：逐条记录本节拍交付的事件
+  * @param  records: 事件记录
+  * @param  count: 记录条数
+  * @retval None
+  */
+static void sim_on_batch(const ButtonEventRecord* records, int count)
+{
+    for (int i = 0; i < count; i++) {
+        sim_store(records[i].button, (ButtonEvent)records[i].event, records[i].tick,
+                  records[i].repeat, records[i].duration);
+    }
+}
+#endif
+
+/**
+  * @brief  复位仿真：停止所有仿真按键，清空虚拟 GPIO 和事件缓冲区，虚拟时钟归零
+  * @param  None
+  * @retval None
+  */
+void mb_sim_reset(void)
+{
+    int deferred = 0;
+
+    for (uint8_t i = 0; i < sim_count; i++) {
+        button_stop(&sim_buttons[i]);
+        deferred |= button_is_active(&sim_buttons[i]);
+    }
+    // 并发模式下停止请求在下一个节拍开始时应用
+    if (deferred) button_ticks();
+#if BUTTON_ENABLE_BUDGET_SCAN
+    // 工作集已清空：推进一个节拍结束未完成的一轮，使下一轮从第一个按键开始
+    button_ticks_budget(0, NULL, 0);
+#endif
+    sim_count = 0;
+
+#if BUTTON_LAYOUT_SPLIT || BUTTON_ENABLE_TWO_PHASE
+    button_compact(sim_slots, MB_SIM_MAX_BUTTONS);
+#endif
+#if BUTTON_ENABLE_TWO_PHASE
+    button_set_sampler(sim_levels, MB_SIM_MAX_BUTTONS, NULL);
+#endif
+
+    memset(sim_gpio, 0, sizeof(sim_gpio));
+    memset(sim_active, 0, sizeof(sim_active));
+    sim_event_count = 0;
+    sim_event_lost = 0;
+    sim_capture_mask = MB_SIM_CAPTURE_ALL;
+    sim_base = button_get_tick();
+}
+
+/**
+  * @brief  添加一个仿真按键：初始化、挂接捕获回调（关闭回调时使用批量处理函数）并启动，初始为松开状态
+  * @param  button_id: 按键标识符（虚拟 GPIO 编号）
+  * @param  active_level: 按下时的电平
+  * @retval 按键句柄，超出 MB_SIM_MAX_BUTTONS 时返回 NULL
+  */
+Button* mb_sim_add(uint8_t button_id, uint8_t active_level)
+{
+    Button* btn;
+
+    if (sim_count >= MB_SIM_MAX_BUTTONS) return NULL;
+
+    btn = &sim_buttons[sim_count];
+    sim_active[button_id] = active_level ? 1 : 0;
+    sim_gpio[button_id] = !sim_active[button_id];
+
+#if BUTTON_ENABLE_MMIO
+    // 虚拟 GPIO 本身就在内存中：按字节绑定，跳过 HAL 函数（需要 BUTTON_MMIO_WORD 为 uint8_t）
+    button_init_mmio(btn, (const volatile ButtonInputWord*)&sim_gpio[button_id], 1, sim_active[button_id], button_id);
+#else
+    button_init(btn, mb_sim_read, sim_active[button_id], button_id);
+#endif
+#if BUTTON_ENABLE_CALLBACKS
+    for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+        button_attach(btn, (ButtonEvent)ev, sim_capture_cb[ev]);
+    }
+#else
+    button_set_batch_sink(sim_on_batch);
+#endif
+    if (button_start(btn) != 0) return NULL;
+
+    sim_count++;
+    return btn;
+}
+
+/**
+  * @brief  推进虚拟时钟
+  * @param  ticks: 要执行的节拍数
+  * @retval None
+  */
+void mb_sim_run(uint32_t ticks)
+{
+    while (ticks--) {
+#if BUTTON_ENABLE_BUDGET_SCAN
+        button_ticks_budget(MB_SIM_SCAN_BUDGET, NULL, 0);
+#else
+        button_ticks();
+#endif
+    }
+}
+
+/**
+  * @brief  获取虚拟时钟
+  * @param  None
+  * @retval 自 mb_sim_reset() 以来的节拍数
+  */
+uint32_t mb_sim_now(void)
+{
+    return button_get_tick() - sim_base;
+}
+
+/**
+  * @brief  虚拟 GPIO 读取函数，作为仿真按键的 HAL 函数
+  * @param  button_id: 按键标识符
+  * @retval 当前电平
+  */
+uint8_t mb_sim_read(uint8_t button_id)
+{
+    return sim_gpio[button_id];
+}
+
+/**
+  * @brief  设置按键的物理状态（按有效电平换算为 GPIO 电平），不推进时钟
+  * @param  button_id: 按键标识符
+  * @param  pressed: 1 按下，0 松开
+  * @retval None
+  */
+void mb_sim_set(uint8_t button_id, uint8_t pressed)
+{
+    sim_gpio[button_id] = pressed ? sim_active[button_id] : !sim_active[button_id];
+}
+
+/**
+  * @brief  按下并保持
+  * @param  button_id: 按键标识符
+  * @param  hold_ticks: 保持的节拍数
+  * @retval None
+  */
+void mb_sim_press(uint8_t button_id, uint32_t hold_ticks)
+{
+    mb_sim_set(button_id, 1);
+    mb_sim_run(hold_ticks);
+}
+
+/**
+  * @brief  松开并保持
+  * @param  button_id: 按键标识符
+  * @param  idle_ticks: 保持松开的节拍数
+  * @retval None
+  */
+void mb_sim_release(uint8_t button_id, uint32_t idle_ticks)
+{
+    mb_sim_set(button_id, 0);
+    mb_sim_run(idle_ticks);
+}
+
+/**
+  * @brief  一次点击：按下 press_ticks，再松开 gap_ticks
+  * @param  button_id: 按键标识符
+  * @param  press_ticks: 按下的节拍数
+  * @param  gap_ticks: 松开后的节拍数
+  * @retval None
+  */
+void mb_sim_click(uint8_t button_id, uint32_t press_ticks, uint32_t gap_ticks)
+{
+    mb_sim_press(button_id, press_ticks);
+    mb_sim_release(button_id, gap_ticks);
+}
+
+/**
+  * @brief  模拟触点抖动：向目标状态切换时来回跳变 edges 次，每次持续 edge_ticks，最后停在目标状态
+  * @param  button_id: 按键标识符
+  * @param  pressed: 目标状态（1 按下，0 松开）
+  * @param  edges: 跳变次数
+  * @param  edge_ticks: 每次跳变持续的节拍数
+  * @retval None
+  *
+  * @note 结束时只设置电平，不推进时钟，之后通常接 mb_sim_press()/mb_sim_release()
+  */
+void mb_sim_bounce(uint8_t button_id, uint8_t pressed, uint8_t edges, uint32_t edge_ticks)
+{
+    for (uint8_t i = 0; i < edges; i++) {
+        mb_sim_set(button_id, (i & 1) ? !pressed : pressed);
+        mb_sim_run(edge_ticks);
+    }
+    mb_sim_set(button_id, pressed);
+}
+
+#if BUTTON_ENABLE_ENCODER
+/**
+  * @brief  转动仿真编码器：在 A/B 两相的虚拟 GPIO 上按格雷码顺序产生相位跳变
+  * @param  a_id: A 相通道
+  * @param  b_id: B 相通道
+  * @param  steps: 相位跳变数，正数为顺时针（A 相超前），负数为逆时针
+  * @param  step_ticks: 每个相位保持的节拍数
+  * @retval None
+  */
+void mb_sim_turn(uint8_t a_id, uint8_t b_id, int32_t steps, uint32_t step_ticks)
+{
+    static const uint8_t gray[4] = { 0, 2, 3, 1 };    // 顺时针的相位顺序，相位 = (A << 1) | B
+    uint8_t ab = (uint8_t)((sim_gpio[a_id] ? 2 : 0) | (sim_gpio[b_id] ? 1 : 0));
+    uint8_t pos = 0;
+
+    while (gray[pos] != ab) pos++;
+
+    for (; steps; steps += (steps > 0) ? -1 : 1) {
+        pos = (uint8_t)((pos + ((steps > 0) ? 1 : 3)) & 3);
+        sim_gpio[a_id] = gray[pos] >> 1;
+        sim_gpio[b_id] = gray[pos] & 1;
+        mb_sim_run(step_ticks);
+    }
+}
+#endif
+
+/**
+  * @brief  设置需要捕获的事件（例如排除高频的 BTN_LONG_PRESS_HOLD）
+  * @param  event_mask: 事件位掩码，第 n 位对应事件 n
+  * @retval None
+  */
+void mb_sim_capture(uint32_t event_mask)
+{
+    sim_capture_mask = event_mask;
+}
+
+/**
+  * @brief  获取已捕获的事件
+  * @param  count: 输出事件条数，可为 NULL
+  * @retval 事件数组（按产生顺序）
+  */
+const MbSimEvent* mb_sim_events(int* count)
+{
+    if (count) *count = sim_event_count;
+    return sim_events;
+}
+
+/**
+  * @brief  统计某类事件的捕获条数
+  * @param  event: 事件类型
+  * @retval 条数
+  */
+int mb_sim_count(ButtonEvent event)
+{
+    int n = 0;
+
+    for (int i = 0; i < sim_event_count; i++) {
+        if (sim_events[i].event == (uint8_t)event) n++;
+    }
+    return n;
+}
+
+/**
+  * @brief  获取因缓冲区满而丢弃的事件数
+  * @param  None
+  * @retval 丢弃条数
+  */
+uint32_t mb_sim_events_lost(void)
+{
+    return sim_event_lost;
+}
+
+/**
+  * @brief  清空事件缓冲区（不影响虚拟时钟和按键状态）
+  * @param  None
+  * @retval None
+  */
+void mb_sim_clear_events(void)
+{
+    sim_event_count = 0;
+    sim_event_lost = 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * MultiButton 仿真库：虚拟时钟 + 虚拟 GPIO
+ * 在主机上以远快于实时的速度驱动 button_ticks()，用于确定性测试和时序扫描。
+ * 仿真接管整个按键库（全局链表与节拍），使用前先调用 mb_sim_reset()。
+ */
+
+#ifndef _MB_SIM_H_
+#define _MB_SIM_H_
+
+#include "multi_button.h"
+
+#if !BUTTON_ENABLE_CALLBACKS && !BUTTON_EVENT_BATCH_SIZE
+#error "mb_sim captures events through callbacks or the batch sink: enable one of them"
+#endif
+
+// 仿真按键的最大数量
+#ifndef MB_SIM_MAX_BUTTONS
+#define MB_SIM_MAX_BUTTONS      16
+#endif
+
+// 事件捕获缓冲区容量（条），写满后丢弃并计数
+#ifndef MB_SIM_MAX_EVENTS
+#define MB_SIM_MAX_EVENTS       65536
+#endif
+
+// 限时增量扫描：每个虚拟节拍最多服务的按键数，0 表示每节拍扫描全部按键（与 button_ticks() 等价）。
+// 小于按键数时一轮跨越多个节拍：mb_sim_add() 把按键插入链表头部，按添加顺序的倒序分段服务
+#ifndef MB_SIM_SCAN_BUDGET
+#define MB_SIM_SCAN_BUDGET      0
+#endif
+
+// 捕获所有事件的掩码
+#define MB_SIM_CAPTURE_ALL      ((1u << BTN_EVENT_COUNT) - 1u)
+
+// Captured event
+// 捕获到的事件
+typedef struct {
+    uint32_t tick;                      ///< 事件产生时的虚拟节拍（自 mb_sim_reset() 起计）
+    uint32_t duration;                  ///< BTN_PRESS_UP/BTN_PRESS_REPEAT 携带的时长，其他事件为 0
+    uint8_t  button_id;                 ///< 产生事件的按键
+    uint8_t  event;                     ///< 事件类型（ButtonEvent）
+    uint8_t  repeat;                    ///< 事件产生时的重复按下次数
+} MbSimEvent;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Simulation control
+void     mb_sim_reset(void);
+Button*  mb_sim_add(uint8_t button_id, uint8_t active_level);
+void     mb_sim_run(uint32_t ticks);
+uint32_t mb_sim_now(void);
+
+// Virtual GPIO
+uint8_t  mb_sim_read(uint8_t button_id);
+void     mb_sim_set(uint8_t button_id, uint8_t pressed);
+
+// Scripted input primitives
+void     mb_sim_press(uint8_t button_id, uint32_t hold_ticks);
+void     mb_sim_release(uint8_t button_id, uint32_t idle_ticks);
+void     mb_sim_click(uint8_t button_id, uint32_t press_ticks, uint32_t gap_ticks);
+void     mb_sim_bounce(uint8_t button_id, uint8_t pressed, uint8_t edges, uint32_t edge_ticks);
+#if BUTTON_ENABLE_ENCODER
+void     mb_sim_turn(uint8_t a_id, uint8_t b_id, int32_t steps, uint32_t step_ticks);
+#endif
+
+// Event capture
+void     mb_sim_capture(uint32_t event_mask);
+const MbSimEvent* mb_sim_events(int* count);
+int      mb_sim_count(ButtonEvent event);
+uint32_t mb_sim_events_lost(void);
+void     mb_sim_clear_events(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * MultiButton 并发配置压力测试
+ * 一个线程连续运行 button_ticks()（按键电平随机翻转，状态机和回调持续运行），
+ * 其余线程同时对各自负责的按键反复 button_start()/button_stop()/button_attach()/button_detach()。
+ * 全部线程结束后，每个按键的 button_is_active() 必须等于其负责线程最后一次请求的状态。
+ * 以 -DBUTTON_ENABLE_CONCURRENT=1 -fsanitize=thread 编译，ThreadSanitizer 同时检查数据竞争。
+ *
+ * 编译并运行：make stress_test
+ */
+
+#define _POSIX_C_SOURCE 200112L
+#include "multi_button.h"
+#include <stdio.h>
+#include <pthread.h>
+
+#if !BUTTON_ENABLE_CONCURRENT
+#error "concurrent_stress requires BUTTON_ENABLE_CONCURRENT=1"
+#endif
+
+#define STRESS_BUTTONS      48      // 按键总数
+#define STRESS_WORKERS      3       // 配置线程数，按键按序号轮流分配给各线程
+#define STRESS_OPS          200000  // 每个配置线程的操作次数
+
+static Button buttons[STRESS_BUTTONS];
+static uint8_t levels[STRESS_BUTTONS];      // 虚拟电平，由节拍线程翻转
+static uint8_t expected[STRESS_BUTTONS];    // 负责线程最后一次请求的状态：1 启动，0 停止
+static int workers_done = 0;                // 已结束的配置线程数
+static uint32_t callbacks = 0;              // 节拍线程中执行的回调次数
+
+/**
+  * @brief  虚拟 GPIO 读取函数
+  * @param  button_id: 按键标识符
+  * @retval 当前电平
+  */
+static uint8_t read_level(uint8_t button_id)
+{
+    return __atomic_load_n(&levels[button_id], __ATOMIC_RELAXED);
+}
+
+/**
+  * @brief  事件回调：计数（只在节拍线程中执行）
+  * @param  btn: 按键
+  * @retval None
+  */
+static void on_event(Button* btn)
+{
+    (void)btn;
+    callbacks++;
+}
+
+/**
+  * @brief  xorshift32 伪随机数
+  * @param  state: 状态
+  * @retval 随机数
+  */
+static uint32_t rng(uint32_t* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**
+  * @brief  节拍线程：翻转电平并运行 button_ticks()，直到所有配置线程结束后再多运行一个节拍
+  * @param  arg: 未使用
+  * @retval NULL
+  */
+static void* tick_thread(void* arg)
+{
+    uint32_t seed = 1;
+    uint32_t ticks = 0;
+
+    (void)arg;
+    while (__atomic_load_n(&workers_done, __ATOMIC_ACQUIRE) < STRESS_WORKERS) {
+        uint32_t r = rng(&seed);
+
+        // 每个节拍随机翻转一个按键，保持长按和点击都会出现
+        if ((r & 7) == 0) {
+            uint8_t id = (uint8_t)((r >> 8) % STRESS_BUTTONS);
+            __atomic_store_n(&levels[id], (uint8_t)!levels[id], __ATOMIC_RELAXED);
+        }
+        button_ticks();
+        ticks++;
+    }
+    // 节拍边界：应用最后登记的请求
+    button_ticks();
+    printf("Ticker: %u ticks, %u callbacks\n", ticks + 1, callbacks);
+    return NULL;
+}
+
+/**
+  * @brief  配置线程：对序号 n % STRESS_WORKERS == 线程号的按键随机启动、停止、挂接、移除回调
+  * @param  arg: 线程号
+  * @retval NULL
+  */
+static void* worker_thread(void* arg)
+{
+    int self = (int)(size_t)arg;
+    uint32_t seed = 0x9e3779b9u * (uint32_t)(self + 1);
+
+    for (int i = 0; i < STRESS_OPS; i++) {
+        uint32_t r = rng(&seed);
+        int n = (int)((r >> 4) % (STRESS_BUTTONS / STRESS_WORKERS)) * STRESS_WORKERS + self;
+        ButtonEvent ev = (ButtonEvent)((r >> 12) % BTN_EVENT_COUNT);
+
+        switch (r & 3) {
+        case 0:
+            button_start(&buttons[n]);
+            expected[n] = 1;
+            break;
+        case 1:
+            button_stop(&buttons[n]);
+            expected[n] = 0;
+            break;
+        case 2:
+            button_attach(&buttons[n], ev, on_event);
+            break;
+        default:
+            button_detach(&buttons[n], ev);
+            break;
+        }
+    }
+    __atomic_fetch_add(&workers_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t ticker, workers[STRESS_WORKERS];
+    int failures = 0;
+
+    for (uint8_t i = 0; i < STRESS_BUTTONS; i++) {
+        button_init(&buttons[i], read_level, 1, i);
+        button_attach(&buttons[i], BTN_SINGLE_CLICK, on_event);
+        if (i & 1) {
+            button_start(&buttons[i]);
+            expected[i] = 1;
+        }
+    }
+
+    pthread_create(&ticker, NULL, tick_thread, NULL);
+    for (int w = 0; w < STRESS_WORKERS; w++) {
+        pthread_create(&workers[w], NULL, worker_thread, (void*)(size_t)w);
+    }
+    for (int w = 0; w < STRESS_WORKERS; w++) pthread_join(workers[w], NULL);
+    pthread_join(ticker, NULL);
+
+    for (int i = 0; i < STRESS_BUTTONS; i++) {
+        if (button_is_active(&buttons[i]) != expected[i]) {
+            printf("FAIL button %d: active %d, expected %d\n", i, button_is_active(&buttons[i]), expected[i]);
+            failures++;
+        }
+    }
+
+    if (failures) {
+        printf("%d button(s) in the wrong state\n", failures);
+        return 1;
+    }
+    printf("Concurrent stress passed\n");
+    return 0;
+}
@@ -0,0 +1,540 @@
+/*
+ * MultiButton 差分模糊测试
+ * 把任意字节解码为 1~4 个按键的电平序列，交给每个已登记的引擎执行，报告第一条
+ * 与参考实现 button_handler()（原始状态机的冻结副本，引擎 0）不一致的事件。
+ *
+ * libFuzzer：  clang -fsanitize=fuzzer -DMB_FUZZ_LIBFUZZER ...（make fuzz_libfuzzer）
+ * 独立运行：   fuzz_diff [-n inputs] [-s seed] [-t]     （make fuzz）
+ *   -n  检查的随机输入个数（默认 20000）
+ *   -s  伪随机数种子
+ *   -t  吞吐量模式：在相同输入上分别为每个引擎计时
+ *
+ * 测试新引擎时实现 FuzzEngine 并加入 fuzz_engines[]。
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "mb_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FUZZ_MAX_BUTTONS    4
+#define FUZZ_MAX_STEPS      1024
+#define FUZZ_MAX_TICKS      8000        // 使 LONG_PRESS_HOLD 事件不超出事件缓冲区
+#define FUZZ_MAX_EVENTS     (FUZZ_MAX_TICKS * FUZZ_MAX_BUTTONS * 2)
+
+// 输入的一步：保持给定电平（第 n 位 = 按键 n 按下）若干节拍
+typedef struct {
+    uint8_t  levels;                    // 各按键电平
+    uint16_t ticks;                     // 保持的节拍数
+} FuzzStep;
+
+// 解码后的输入
+typedef struct {
+    uint8_t  nbuttons;                  // 按键数
+    int      nsteps;                    // 步数
+    FuzzStep steps[FUZZ_MAX_STEPS];
+} FuzzInput;
+
+// 引擎产生的一条事件
+typedef struct {
+    uint32_t tick;
+    uint8_t  button_id;
+    uint8_t  event;
+    uint8_t  repeat;
+    uint32_t duration;                  // BTN_PRESS_UP/BTN_PRESS_REPEAT 携带的时长，其他事件为 0
+} FuzzEvent;
+
+// 引擎产生的事件流
+typedef struct {
+    int       count;
+    FuzzEvent events[FUZZ_MAX_EVENTS];
+} FuzzTrace;
+
+// 引擎接口：从初始状态执行整个输入并记录每条事件
+typedef struct {
+    const char* name;
+    void (*run)(const FuzzInput* in, FuzzTrace* out);
+} FuzzEngine;
+
+/**
+  * @brief  向事件流追加一条事件，满时丢弃
+  * @param  out: 事件流
+  * @param  tick: 节拍
+  * @param  id: 按键
+  * @param  event: 事件类型
+  * @param  repeat: 重复按下次数
+  * @param  duration: 事件携带的时长
+  * @retval None
+  */
+static void trace_add(FuzzTrace* out, uint32_t tick, uint8_t id, uint8_t event, uint8_t repeat, uint32_t duration)
+{
+    if (out->count < FUZZ_MAX_EVENTS) {
+        FuzzEvent* ev = &out->events[out->count++];
+        ev->tick = tick;
+        ev->button_id = id;
+        ev->event = event;
+        ev->repeat = repeat;
+        ev->duration = duration;
+    }
+}
+
+/*---------------- 参考引擎：原始的 button_handler() ----------------*/
+
+// 参考按键状态（原始结构体的字段）
+typedef struct {
+    uint16_t ticks;
+    uint8_t  repeat;
+    uint8_t  state;
+    uint8_t  debounce_cnt;
+    uint8_t  button_level;
+} RefButton;
+
+static FuzzTrace* ref_out;      // 参考引擎的输出
+static uint32_t ref_tick;       // 参考引擎的当前节拍
+
+// 原始状态机没有时长字段：PRESS_UP 时 ticks 为按下时长，PRESS_REPEAT 时为与上次松开的间隔
+#define REF_EVENT(ev)  trace_add(ref_out, ref_tick, id, (uint8_t)(ev), b->repeat, \
+                                 ((ev) == BTN_PRESS_UP || (ev) == BTN_PRESS_REPEAT) ? b->ticks : 0)
+
+/**
+  * @brief  原始状态机（冻结副本，不随库修改）
+  * @param  b: 参考按键
+  * @param  id: 按键编号
+  * @param  level: 本节拍电平
+  * @retval None
+  */
+static void ref_handler(RefButton* b, uint8_t id, uint8_t level)
+{
+    const uint8_t active_level = 1;
+
+    if (b->state > BTN_STATE_IDLE) b->ticks++;
+
+    if (level != b->button_level) {
+        if (++(b->debounce_cnt) >= DEBOUNCE_TICKS) {
+            b->button_level = level;
+            b->debounce_cnt = 0;
+        }
+    } else {
+        b->debounce_cnt = 0;
+    }
+
+    switch (b->state) {
+    case BTN_STATE_IDLE:
+        if (b->button_level == active_level) {
+            REF_EVENT(BTN_PRESS_DOWN);
+            b->ticks = 0;
+            b->repeat = 1;
+            b->state = BTN_STATE_PRESS;
+        }
+        break;
+
+    case BTN_STATE_PRESS:
+        if (b->button_level != active_level) {
+            REF_EVENT(BTN_PRESS_UP);
+            b->ticks = 0;
+            b->state = BTN_STATE_RELEASE;
+        } else if (b->ticks > LONG_TICKS) {
+            REF_EVENT(BTN_LONG_PRESS_START);
+            b->state = BTN_STATE_LONG_HOLD;
+        }
+        break;
+
+    case BTN_STATE_RELEASE:
+        if (b->button_level == active_level) {
+            REF_EVENT(BTN_PRESS_DOWN);
+            if (b->repeat < PRESS_REPEAT_MAX_NUM) b->repeat++;
+            REF_EVENT(BTN_PRESS_REPEAT);
+            b->ticks = 0;
+            b->state = BTN_STATE_REPEAT;
+        } else if (b->ticks > SHORT_TICKS) {
+            if (b->repeat == 1) REF_EVENT(BTN_SINGLE_CLICK);
+            else if (b->repeat == 2) REF_EVENT(BTN_DOUBLE_CLICK);
+            b->state = BTN_STATE_IDLE;
+        }
+        break;
+
+    case BTN_STATE_REPEAT:
+        if (b->button_level != active_level) {
+            REF_EVENT(BTN_PRESS_UP);
+            if (b->ticks < SHORT_TICKS) {
+                b->ticks = 0;
+                b->state = BTN_STATE_RELEASE;
+            } else {
+                b->state = BTN_STATE_IDLE;
+            }
+        } else if (b->ticks > SHORT_TICKS) {
+            b->state = BTN_STATE_PRESS;
+        }
+        break;
+
+    case BTN_STATE_LONG_HOLD:
+        if (b->button_level == active_level) {
+            REF_EVENT(BTN_LONG_PRESS_HOLD);
+        } else {
+            REF_EVENT(BTN_PRESS_UP);
+            b->state = BTN_STATE_IDLE;
+        }
+        break;
+
+    default:
+        b->state = BTN_STATE_IDLE;
+        break;
+    }
+}
+
+#if BUTTON_ENABLE_BUDGET_SCAN && MB_SIM_SCAN_BUDGET
+/**
+  * @brief  限时增量扫描下按键 i 是否在第 tick 个节拍被服务
+  * @param  i: 按键编号
+  * @param  nbuttons: 按键数
+  * @param  tick: 节拍（从 1 开始）
+  * @retval 1: 被服务，0: 本节拍跳过
+  *
+  * @note mb_sim_add() 把按键插入链表头部，按键 i 位于第 nbuttons - 1 - i 个位置；每节拍服务
+  *       MB_SIM_SCAN_BUDGET 个，到达末尾即结束一轮，一轮占 ceil(nbuttons / MB_SIM_SCAN_BUDGET) 个节拍
+  */
+static int ref_served(uint8_t i, uint8_t nbuttons, uint32_t tick)
+{
+    uint32_t round = (nbuttons + MB_SIM_SCAN_BUDGET - 1) / MB_SIM_SCAN_BUDGET;
+
+    return (uint32_t)(nbuttons - 1 - i) / MB_SIM_SCAN_BUDGET == (tick - 1) % round;
+}
+#endif
+
+/**
+  * @brief  参考引擎：每节拍依次处理全部按键
+  * @param  in: 输入
+  * @param  out: 输出事件流
+  * @retval None
+  *
+  * @note 限时增量扫描变体按库的轮转顺序只在被服务的节拍调用原始状态机：去抖按服务次数计数，
+  *       计时则补上未被服务的节拍（库按节拍时间戳计时），得到与预算相同的期望事件流
+  */
+static void ref_run(const FuzzInput* in, FuzzTrace* out)
+{
+    RefButton buttons[FUZZ_MAX_BUTTONS];
+#if BUTTON_ENABLE_BUDGET_SCAN && MB_SIM_SCAN_BUDGET
+    uint32_t entry[FUZZ_MAX_BUTTONS] = { 0 };   // 各按键进入当前状态时的节拍
+#endif
+
+    memset(buttons, 0, sizeof(buttons));
+    ref_out = out;
+    ref_tick = 0;
+    out->count = 0;
+
+    for (int s = 0; s < in->nsteps; s++) {
+        for (uint16_t t = 0; t < in->steps[s].ticks; t++) {
+            ref_tick++;
+            for (uint8_t i = 0; i < in->nbuttons; i++) {
+#if BUTTON_ENABLE_BUDGET_SCAN && MB_SIM_SCAN_BUDGET
+                if (!ref_served(i, in->nbuttons, ref_tick)) continue;
+                if (buttons[i].state > BTN_STATE_IDLE) buttons[i].ticks = (uint16_t)(ref_tick - entry[i] - 1);
+                ref_handler(&buttons[i], i, (in->steps[s].levels >> i) & 1);
+                if (buttons[i].ticks == 0) entry[i] = ref_tick;
+#else
+                ref_handler(&buttons[i], i, (in->steps[s].levels >> i) & 1);
+#endif
+            }
+        }
+    }
+}
+
+/*---------------- 库引擎：按当前选项编译的 multi_button.c，由 mb_sim 驱动 ----------------*/
+
+#if BUTTON_LAYOUT_SPLIT
+#define LIB_VARIANT "split"
+#elif BUTTON_LAYOUT_FAST
+#define LIB_VARIANT "fast"
+#elif BUTTON_ENABLE_CONCURRENT
+#define LIB_VARIANT "concurrent"
+#elif BUTTON_EVENT_BATCH_SIZE
+#define LIB_VARIANT "batch"
+#elif BUTTON_ENABLE_TWO_PHASE
+#define LIB_VARIANT "twophase"
+#elif BUTTON_ENABLE_BUDGET_SCAN
+#define FUZZ_STR(x)     #x
+#define FUZZ_XSTR(x)    FUZZ_STR(x)
+#define LIB_VARIANT "budget" FUZZ_XSTR(MB_SIM_SCAN_BUDGET)
+#elif BUTTON_ENABLE_MMIO
+#define LIB_VARIANT "mmio"
+#else
+#define LIB_VARIANT "default"
+#endif
+
+/**
+  * @brief  库引擎：在仿真器中执行输入
+  * @param  in: 输入
+  * @param  out: 输出事件流
+  * @retval None
+  */
+static void lib_run(const FuzzInput* in, FuzzTrace* out)
+{
+    const MbSimEvent* ev;
+    int n;
+
+    mb_sim_reset();
+    for (uint8_t i = 0; i < in->nbuttons; i++) mb_sim_add(i, 1);
+
+    for (int s = 0; s < in->nsteps; s++) {
+        for (uint8_t i = 0; i < in->nbuttons; i++) mb_sim_set(i, (in->steps[s].levels >> i) & 1);
+        mb_sim_run(in->steps[s].ticks);
+    }
+
+    out->count = 0;
+    ev = mb_sim_events(&n);
+    for (int i = 0; i < n; i++) {
+        // 参考实现早于 BTN_LONG_PRESS_STAGE；默认时序配置不会产生该事件
+        trace_add(out, ev[i].tick, ev[i].button_id, ev[i].event, ev[i].repeat, ev[i].duration);
+    }
+}
+
+// 已登记的引擎；引擎 0 为参考，其余引擎都与它比较
+static const FuzzEngine fuzz_engines[] = {
+    { "reference", ref_run },
+    { "library(" LIB_VARIANT ")", lib_run },
+};
+
+#define FUZZ_ENGINE_COUNT   ((int)(sizeof(fuzz_engines) / sizeof(fuzz_engines[0])))
+
+/*---------------- 输入解码与比较 ----------------*/
+
+/**
+  * @brief  解码一步的时长，偏向去抖、点击和长按三个时间尺度
+  * @param  d: 输入字节
+  * @retval 节拍数
+  */
+static uint16_t decode_ticks(uint8_t d)
+{
+    if (d < 128) return (uint16_t)(d % 8 + 1);
+    if (d < 224) return (uint16_t)(d - 128 + 1);
+    return (uint16_t)(LONG_TICKS - 64 + (d - 224) * 8);
+}
+
+/**
+  * @brief  把任意字节解码为输入：首字节为按键数，其后每两个字节为一步（电平、时长）
+  * @param  data: 字节
+  * @param  size: 字节数
+  * @param  in: 输出输入
+  * @retval None
+  */
+static void decode(const uint8_t* data, size_t size, FuzzInput* in)
+{
+    uint32_t total = 0;
+
+    in->nbuttons = size ? (uint8_t)(data[0] % FUZZ_MAX_BUTTONS + 1) : 1;
+    in->nsteps = 0;
+    for (size_t i = 1; i + 1 < size && in->nsteps < FUZZ_MAX_STEPS - 1; i += 2) {
+        uint16_t ticks = decode_ticks(data[i + 1]);
+        if (total + ticks > FUZZ_MAX_TICKS) break;
+        in->steps[in->nsteps].levels = data[i];
+        in->steps[in->nsteps].ticks = ticks;
+        in->nsteps++;
+        total += ticks;
+    }
+    // 最后总是全部松开并空闲足够久，使未完成的点击产生事件
+    in->steps[in->nsteps].levels = 0;
+    in->steps[in->nsteps].ticks = SHORT_TICKS * 2;
+    in->nsteps++;
+}
+
+/**
+  * @brief  按（节拍，按键）稳定排序：引擎在同一节拍内访问按键的顺序可能不同
+  * @param  t: 事件流
+  * @retval None
+  */
+static void canonical(FuzzTrace* t)
+{
+    for (int i = 1; i < t->count; i++) {
+        FuzzEvent key = t->events[i];
+        int j = i - 1;
+
+        while (j >= 0 && (t->events[j].tick > key.tick ||
+                          (t->events[j].tick == key.tick && t->events[j].button_id > key.button_id))) {
+            t->events[j + 1] = t->events[j];
+            j--;
+        }
+        t->events[j + 1] = key;
+    }
+}
+
+/**
+  * @brief  输出事件流中的第 i 条事件
+  * @param  label: 引擎名
+  * @param  t: 事件流
+  * @param  i: 序号
+  * @retval None
+  */
+static void print_event(const char* label, const FuzzTrace* t, int i)
+{
+    if (i < t->count) {
+        const FuzzEvent* ev = &t->events[i];
+        printf("  %-22s tick %u button %u event %u repeat %u duration %u\n", label, (unsigned)ev->tick,
+               (unsigned)ev->button_id, (unsigned)ev->event, (unsigned)ev->repeat, (unsigned)ev->duration);
+    } else {
+        printf("  %-22s (no more events)\n", label);
+    }
+}
+
+/**
+  * @brief  比较两条事件
+  * @retval 1: 相同，0: 不同
+  */
+static int same_event(const FuzzEvent* a, const FuzzEvent* b)
+{
+    return a->tick == b->tick && a->button_id == b->button_id &&
+           a->event == b->event && a->repeat == b->repeat && a->duration == b->duration;
+}
+
+static FuzzTrace traces[FUZZ_ENGINE_COUNT];     // 各引擎的事件流
+
+/**
+  * @brief  用所有引擎执行同一输入并比较
+  * @param  data: 字节
+  * @param  size: 字节数
+  * @retval 第一个不一致的引擎序号；全部一致返回 0
+  */
+static int check_input(const uint8_t* data, size_t size)
+{
+    static FuzzInput in;
+
+    decode(data, size, &in);
+    for (int e = 0; e < FUZZ_ENGINE_COUNT; e++) {
+        fuzz_engines[e].run(&in, &traces[e]);
+        canonical(&traces[e]);
+    }
+
+    for (int e = 1; e < FUZZ_ENGINE_COUNT; e++) {
+        const FuzzTrace* ref = &traces[0];
+        const FuzzTrace* alt = &traces[e];
+
+        for (int i = 0; i < ref->count || i < alt->count; i++) {
+            if (i < ref->count && i < alt->count && same_event(&ref->events[i], &alt->events[i])) continue;
+
+            printf("DIVERGENCE: %s vs %s at event #%d (%u buttons, %d steps)\n",
+                   fuzz_engines[0].name, fuzz_engines[e].name, i, in.nbuttons, in.nsteps);
+            print_event(fuzz_engines[0].name, ref, i);
+            print_event(fuzz_engines[e].name, alt, i);
+            printf("  input:");
+            for (size_t b = 0; b < size; b++) printf(" %02x", data[b]);
+            printf("\n");
+            return e;
+        }
+    }
+    return 0;
+}
+
+#ifdef MB_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (check_input(data, size)) abort();   // libFuzzer 保存导致失败的输入
+    return 0;
+}
+
+#else
+
+static uint32_t rng_state = 1;  // 伪随机数状态
+
+/**
+  * @brief  xorshift32 伪随机数
+  * @param  None
+  * @retval 随机数
+  */
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/**
+  * @brief  生成随机长度的随机输入
+  * @param  buf: 输出缓冲区
+  * @param  max: 缓冲区容量
+  * @retval 字节数
+  */
+static size_t random_input(uint8_t* buf, size_t max)
+{
+    size_t size = 1 + (rng() % (max - 1));
+
+    for (size_t i = 0; i < size; i++) buf[i] = (uint8_t)rng();
+    return size;
+}
+
+/**
+  * @brief  获取单调时钟（秒）
+  * @param  None
+  * @retval 当前时间
+  */
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+  * @brief  在相同的随机输入上分别为每个引擎计时
+  * @param  inputs: 输入个数
+  * @param  seed: 伪随机数种子
+  * @retval None
+  */
+static void throughput(int inputs, uint32_t seed)
+{
+    static uint8_t buf[256];
+    static FuzzInput in;
+
+    for (int e = 0; e < FUZZ_ENGINE_COUNT; e++) {
+        double ticks = 0, events = 0, t0;
+
+        rng_state = seed;
+        t0 = now_s();
+        for (int i = 0; i < inputs; i++) {
+            size_t size = random_input(buf, sizeof(buf));
+            decode(buf, size, &in);
+            fuzz_engines[e].run(&in, &traces[e]);
+            for (int s = 0; s < in.nsteps; s++) ticks += (double)in.steps[s].ticks * in.nbuttons;
+            events += traces[e].count;
+        }
+        t0 = now_s() - t0;
+        printf("  %-22s %8.1f M button-ticks/s %8.1f M events/s\n", fuzz_engines[e].name,
+               ticks / t0 / 1e6, events / t0 / 1e6);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    static uint8_t buf[256];
+    int inputs = 20000;
+    uint32_t seed = 1;
+    int bench = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) inputs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-t") == 0) bench = 1;
+    }
+    if (seed == 0) seed = 1;
+
+    if (bench) {
+        printf("Throughput over %d random inputs:\n", inputs);
+        throughput(inputs, seed);
+        return 0;
+    }
+
+    rng_state = seed;
+    for (int i = 0; i < inputs; i++) {
+        size_t size = random_input(buf, sizeof(buf));
+        if (check_input(buf, size)) {
+            printf("  (input %d, seed %u)\n", i, (unsigned)seed);
+            return 1;
+        }
+    }
+    printf("%d random inputs: %s matches %s\n", inputs, fuzz_engines[1].name, fuzz_engines[0].name);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,461 @@
+/*
+ * MultiButton 黄金事件轨迹回归
+ * 通过 mb_sim 虚拟时钟回放 test/golden 中各 .trace 文件的输入脚本，把捕获到的事件
+ * 与轨迹中保存的期望事件流逐条比较。以不同的 BUTTON_* 选项编译即可用同一组轨迹
+ * 检查任意引擎变体。
+ *
+ * 轨迹格式（每行一条指令，'#' 开始注释）：
+ *
+ *   button  <id> <active_level>          添加仿真按键（必须在任何输入之前）
+ *   profile <id> <click> <repeat> <long...>   设置按键时序配置（可选）
+ *   ignore  <EVENT>                      不捕获该类事件
+ *   press   <id> <ticks>                 按下并保持 <ticks> 个节拍
+ *   release <id> <ticks>                 松开并等待 <ticks> 个节拍
+ *   set     <id> <0|1>                   改变电平，不推进时间
+ *   bounce  <id> <0|1> <edges> <ticks>   向指定状态切换时的触点弹跳
+ *   run     <ticks>                      推进时钟
+ *   expect                               文件其余部分为期望事件流：
+ *   <tick> <id> <EVENT> <repeat> <duration>
+ *
+ * 节拍数可以写作 DEBOUNCE、SHORT、LONG 加上 +、-、* 偏移，例如 LONG+1。
+ * 期望节拍对应 multi_button_config.h 中的默认时序常量。
+ *
+ * 限时增量扫描变体（MB_SIM_SCAN_BUDGET > 0）中按键数超过预算的轨迹改用 budget<N>/<名称>.expect 中的期望事件流。
+ *
+ * 用法：golden_test [-r] [-n rounds] file.trace...
+ *   -r  录制：用当前引擎重写每个轨迹的期望事件流
+ *   -n  重复回放 <rounds> 轮并报告吞吐量
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "mb_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_LINES       512
+#define MAX_LINE_LEN    160
+#define MAX_EXPECTED    4096
+
+// 一个轨迹文件
+typedef struct {
+    char     lines[MAX_LINES][MAX_LINE_LEN];   // 输入部分，原样保存
+    int      nlines;                           // 输入行数
+    MbSimEvent expected[MAX_EXPECTED];         // 期望事件流
+    int      nexpected;                        // 期望事件条数
+} Trace;
+
+static const char* event_names[BTN_EVENT_COUNT] = {
+    "PRESS_DOWN", "PRESS_UP", "PRESS_REPEAT", "SINGLE_CLICK",
+    "DOUBLE_CLICK", "LONG_PRESS_START", "LONG_PRESS_HOLD", "LONG_PRESS_STAGE"
+};
+
+#if BUTTON_ENABLE_PROFILE
+static ButtonProfile profiles[MB_SIM_MAX_BUTTONS];   // profile 指令使用的时序配置
+static int nprofiles;                                // 已使用的时序配置数
+#endif
+static Button* buttons[256];     // 按 id 索引的仿真按键，用于逐按键配置
+
+/**
+  * @brief  获取单调时钟（秒）
+  * @param  None
+  * @retval 当前时间
+  */
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+  * @brief  解析事件名
+  * @param  name: 事件名（不含 BTN_ 前缀）
+  * @retval 事件类型，未知名称返回 -1
+  */
+static int parse_event(const char* name)
+{
+    for (int i = 0; i < BTN_EVENT_COUNT; i++) {
+        if (strcmp(name, event_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+/**
+  * @brief  解析节拍数：数字或 DEBOUNCE/SHORT/LONG，后面可跟 +n、-n、*n
+  * @param  s: 文本
+  * @retval 节拍数
+  */
+static long parse_ticks(const char* s)
+{
+    char* end;
+    long v;
+
+    if (strncmp(s, "DEBOUNCE", 8) == 0) { v = DEBOUNCE_TICKS; end = (char*)s + 8; }
+    else if (strncmp(s, "SHORT", 5) == 0) { v = SHORT_TICKS; end = (char*)s + 5; }
+    else if (strncmp(s, "LONG", 4) == 0) { v = LONG_TICKS; end = (char*)s + 4; }
+    else v = strtol(s, &end, 10);
+
+    while (*end == '+' || *end == '-' || *end == '*') {
+        char op = *end;
+        long n = strtol(end + 1, &end, 10);
+        v = (op == '+') ? v + n : (op == '-') ? v - n : v * n;
+    }
+    return v;
+}
+
+/**
+  * @brief  解析一行期望事件并追加到轨迹
+  * @param  path: 文件路径（用于错误信息）
+  * @param  line: 文本行
+  * @param  t: 轨迹
+  * @retval 0: 成功（空行和注释行忽略），-1: 格式错误
+  */
+static int parse_expected(const char* path, const char* line, Trace* t)
+{
+    char name[32];
+    unsigned tick, id, repeat, duration;
+    MbSimEvent* ev;
+
+    if (line[0] == '#' || line[0] == '\n') return 0;
+    if (sscanf(line, "%u %u %31s %u %u", &tick, &id, name, &repeat, &duration) != 5 ||
+        parse_event(name) < 0 || t->nexpected >= MAX_EXPECTED) {
+        fprintf(stderr, "%s: bad expected line: %s", path, line);
+        return -1;
+    }
+    ev = &t->expected[t->nexpected++];
+    ev->tick = tick;
+    ev->button_id = (uint8_t)id;
+    ev->event = (uint8_t)parse_event(name);
+    ev->repeat = (uint8_t)repeat;
+    ev->duration = duration;
+    return 0;
+}
+
+/**
+  * @brief  读取轨迹文件
+  * @param  path: 文件路径
+  * @param  t: 输出轨迹
+  * @retval 0: 成功，-1: 无法打开或期望事件格式错误
+  */
+static int load_trace(const char* path, Trace* t)
+{
+    char line[MAX_LINE_LEN];
+    int in_expect = 0;
+    FILE* f = fopen(path, "r");
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    t->nlines = 0;
+    t->nexpected = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (in_expect) {
+            if (parse_expected(path, line, t) != 0) {
+                fclose(f);
+                return -1;
+            }
+        } else if (strncmp(line, "expect", 6) == 0) {
+            in_expect = 1;
+        } else if (t->nlines < MAX_LINES) {
+            strcpy(t->lines[t->nlines++], line);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+#if BUTTON_ENABLE_BUDGET_SCAN && MB_SIM_SCAN_BUDGET
+/*
+ * 限时增量扫描：按键数超过 MB_SIM_SCAN_BUDGET 时一轮跨越多个节拍，去抖和事件时刻与逐节拍扫描不同，
+ * 期望事件流另存于轨迹所在目录的 budget<N>/<名称>.expect（只含期望事件行），-r 时录制到该文件。
+ * 按键数不超过预算的轨迹每节拍服务全部按键，仍与轨迹中的期望事件流比较。
+ */
+
+/**
+  * @brief  获取轨迹中的按键数
+  * @param  t: 轨迹
+  * @retval button 指令条数
+  */
+static int trace_buttons(const Trace* t)
+{
+    int n = 0;
+
+    for (int i = 0; i < t->nlines; i++) {
+        if (strncmp(t->lines[i], "button", 6) == 0) n++;
+    }
+    return n;
+}
+
+/**
+  * @brief  获取轨迹在当前预算下的期望事件文件路径
+  * @param  trace: 轨迹文件路径
+  * @param  out: 输出路径
+  * @param  size: 输出缓冲区大小
+  * @retval None
+  */
+static void budget_expect_path(const char* trace, char* out, size_t size)
+{
+    const char* base = strrchr(trace, '/');
+    int dir = base ? (int)(base - trace) + 1 : 0;
+    int name = (int)strlen(trace + dir);
+
+    base = trace + dir;
+    if (name > 6 && strcmp(base + name - 6, ".trace") == 0) name -= 6;
+    snprintf(out, size, "%.*sbudget%d/%.*s.expect", dir, trace, MB_SIM_SCAN_BUDGET, name, base);
+}
+
+/**
+  * @brief  读取期望事件文件，替换轨迹中的期望事件流
+  * @param  path: 期望事件文件路径
+  * @param  t: 轨迹
+  * @retval 0: 成功，-1: 无法打开或格式错误
+  */
+static int load_expected(const char* path, Trace* t)
+{
+    char line[MAX_LINE_LEN];
+    FILE* f = fopen(path, "r");
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    t->nexpected = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (parse_expected(path, line, t) != 0) {
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+#endif
+
+/**
+  * @brief  在仿真器中执行输入部分
+  * @param  path: 文件路径（用于错误信息）
+  * @param  t: 轨迹
+  * @retval 总节拍数；指令错误时返回 -1
+  */
+static long run_trace(const char* path, const Trace* t)
+{
+    uint32_t mask = MB_SIM_CAPTURE_ALL;
+
+    mb_sim_reset();
+#if BUTTON_ENABLE_PROFILE
+    nprofiles = 0;
+#endif
+    memset(buttons, 0, sizeof(buttons));
+
+    for (int i = 0; i < t->nlines; i++) {
+        char cmd[16], a[32], b[32], c[32], d[32], e[32], g[32];
+        int n = sscanf(t->lines[i], "%15s %31s %31s %31s %31s %31s %31s", cmd, a, b, c, d, e, g);
+
+        if (n <= 0 || cmd[0] == '#') continue;
+
+        if (strcmp(cmd, "button") == 0 && n == 3) {
+            uint8_t id = (uint8_t)atoi(a);
+            if (!(buttons[id] = mb_sim_add(id, (uint8_t)atoi(b)))) return -1;
+#if BUTTON_ENABLE_PROFILE
+        } else if (strcmp(cmd, "profile") == 0 && n >= 5 && nprofiles < MB_SIM_MAX_BUTTONS) {
+            ButtonProfile* p = &profiles[nprofiles++];
+            const char* stages[] = { d, e, g };
+            Button* btn = buttons[(uint8_t)atoi(a)];
+
+            memset(p, 0, sizeof(*p));
+            p->click_ticks = (uint32_t)parse_ticks(b);
+            p->repeat_press_ticks = (uint32_t)parse_ticks(c);
+            for (int s = 0; s < n - 4 && s < BUTTON_LONG_STAGE_MAX && s < 3; s++) {
+                p->long_ticks[p->long_stages++] = (uint32_t)parse_ticks(stages[s]);
+            }
+            if (!btn || button_set_profile(btn, p) != 0) return -1;
+#endif
+        } else if (strcmp(cmd, "ignore") == 0 && n == 2 && parse_event(a) >= 0) {
+            mask &= ~(1u << parse_event(a));
+            mb_sim_capture(mask);
+        } else if (strcmp(cmd, "press") == 0 && n == 3) {
+            mb_sim_press((uint8_t)atoi(a), (uint32_t)parse_ticks(b));
+        } else if (strcmp(cmd, "release") == 0 && n == 3) {
+            mb_sim_release((uint8_t)atoi(a), (uint32_t)parse_ticks(b));
+        } else if (strcmp(cmd, "set") == 0 && n == 3) {
+            mb_sim_set((uint8_t)atoi(a), (uint8_t)atoi(b));
+        } else if (strcmp(cmd, "bounce") == 0 && n == 5) {
+            mb_sim_bounce((uint8_t)atoi(a), (uint8_t)atoi(b), (uint8_t)atoi(c), (uint32_t)parse_ticks(d));
+        } else if (strcmp(cmd, "run") == 0 && n == 2) {
+            mb_sim_run((uint32_t)parse_ticks(a));
+        } else {
+            fprintf(stderr, "%s: bad directive: %s", path, t->lines[i]);
+            return -1;
+        }
+    }
+    return (long)mb_sim_now();
+}
+
+/**
+  * @brief  按节拍、再按按键排序，保持每个按键内部的顺序（稳定插入排序）
+  * @param  ev: 事件数组
+  * @param  n: 事件条数
+  * @retval None
+  *
+  * @note 使用遍历表的引擎在同一节拍内访问按键的顺序可能不同
+  */
+static void canonical(MbSimEvent* ev, int n)
+{
+    for (int i = 1; i < n; i++) {
+        MbSimEvent key = ev[i];
+        int j = i - 1;
+
+        while (j >= 0 && (ev[j].tick > key.tick ||
+                          (ev[j].tick == key.tick && ev[j].button_id > key.button_id))) {
+            ev[j + 1] = ev[j];
+            j--;
+        }
+        ev[j + 1] = key;
+    }
+}
+
+/**
+  * @brief  以轨迹格式输出一条事件
+  * @param  f: 输出文件
+  * @param  ev: 事件
+  * @retval None
+  */
+static void print_event(FILE* f, const MbSimEvent* ev)
+{
+    fprintf(f, "%u %u %s %u %u\n", (unsigned)ev->tick, (unsigned)ev->button_id,
+            event_names[ev->event], (unsigned)ev->repeat, (unsigned)ev->duration);
+}
+
+/**
+  * @brief  回放轨迹并与期望事件流比较
+  * @param  path: 文件路径
+  * @param  t: 轨迹
+  * @retval 0: 一致，1: 不一致，-1: 指令错误
+  */
+static int check_trace(const char* path, Trace* t)
+{
+    static MbSimEvent actual[MB_SIM_MAX_EVENTS];
+    const MbSimEvent* captured;
+    int n;
+
+    if (run_trace(path, t) < 0) return -1;
+
+    captured = mb_sim_events(&n);
+    memcpy(actual, captured, sizeof(MbSimEvent) * (size_t)n);
+    canonical(actual, n);
+    canonical(t->expected, t->nexpected);
+
+    for (int i = 0; i < n || i < t->nexpected; i++) {
+        if (i >= n || i >= t->nexpected ||
+            actual[i].tick != t->expected[i].tick || actual[i].button_id != t->expected[i].button_id ||
+            actual[i].event != t->expected[i].event || actual[i].repeat != t->expected[i].repeat ||
+            actual[i].duration != t->expected[i].duration) {
+            printf("FAIL %s: event #%d\n  expected: ", path, i);
+            if (i < t->nexpected) print_event(stdout, &t->expected[i]); else printf("(end)\n");
+            printf("  actual:   ");
+            if (i < n) print_event(stdout, &actual[i]); else printf("(end)\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+  * @brief  回放轨迹并用捕获到的事件重写期望事件流
+  * @param  path: 文件路径
+  * @param  t: 轨迹
+  * @retval 0: 成功，-1: 指令错误或无法写入
+  */
+static int record_trace(const char* path, Trace* t)
+{
+    const MbSimEvent* ev;
+    FILE* f;
+    int n;
+
+    if (run_trace(path, t) < 0) return -1;
+    ev = mb_sim_events(&n);
+
+#if BUTTON_ENABLE_BUDGET_SCAN && MB_SIM_SCAN_BUDGET
+    // 一轮跨越多个节拍：只录制本预算的期望事件文件，不改动轨迹
+    if (trace_buttons(t) > MB_SIM_SCAN_BUDGET) {
+        char expect[MAX_LINE_LEN];
+
+        budget_expect_path(path, expect, sizeof(expect));
+        f = fopen(expect, "w");
+        if (!f) {
+            perror(expect);
+            return -1;
+        }
+        fprintf(f, "# %s, MB_SIM_SCAN_BUDGET=%d\n", path, MB_SIM_SCAN_BUDGET);
+        for (int i = 0; i < n; i++) print_event(f, &ev[i]);
+        fclose(f);
+        printf("recorded %s (%d events)\n", expect, n);
+        return 0;
+    }
+#endif
+
+    f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    for (int i = 0; i < t->nlines; i++) fputs(t->lines[i], f);
+    fputs("expect\n", f);
+    for (int i = 0; i < n; i++) print_event(f, &ev[i]);
+    fclose(f);
+    printf("recorded %s (%d events)\n", path, n);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    static Trace trace;
+    int record = 0, rounds = 0, failures = 0, files = 0;
+    double ticks = 0, events = 0, elapsed = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0) { record = 1; continue; }
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) { rounds = atoi(argv[++i]); continue; }
+
+        if (load_trace(argv[i], &trace) != 0) return 2;
+#if BUTTON_ENABLE_BUDGET_SCAN && MB_SIM_SCAN_BUDGET
+        if (!record && trace_buttons(&trace) > MB_SIM_SCAN_BUDGET) {
+            char expect[MAX_LINE_LEN];
+
+            budget_expect_path(argv[i], expect, sizeof(expect));
+            if (load_expected(expect, &trace) != 0) return 2;
+        }
+#endif
+        files++;
+
+        int rc = record ? record_trace(argv[i], &trace) : check_trace(argv[i], &trace);
+        if (rc < 0) return 2;
+        failures += rc;
+
+        // 吞吐量：重复回放同一输入，不做比较
+        if (rounds > 0) {
+            double t0 = now_s();
+            for (int r = 0; r < rounds; r++) {
+                int n;
+                ticks += (double)run_trace(argv[i], &trace);
+                mb_sim_events(&n);
+                events += n;
+            }
+            elapsed += now_s() - t0;
+        }
+    }
+
+    if (rounds > 0 && elapsed > 0) {
+        printf("Throughput: %.0f ticks, %.0f events in %.3f s (%.1f M ticks/s, %.1f M events/s)\n",
+               ticks, events, elapsed, ticks / elapsed / 1e6, events / elapsed / 1e6);
+    }
+    if (record) return 0;
+
+    printf("%d/%d golden traces passed\n", files - failures, files);
+    return failures ? 1 : 0;
+}
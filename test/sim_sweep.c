@@ -0,0 +1,1368 @@
+/*
+ * MultiButton 仿真时序扫描
+ * 使用 mb_sim 虚拟时钟遍历时序阈值附近的每一种按下时长和点击间隔，检查产生的事件，
+ * 并报告仿真吞吐量。
+ *
+ * 编译并运行：make sim_test
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#ifdef __linux__
+#define _DEFAULT_SOURCE     // syscall()：内存映射输入测试用硬件观察点统计加载次数
+#endif
+#include "mb_sim.h"
+#include <stdio.h>
+#include <time.h>
+#if BUTTON_ENABLE_EVENTFD
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <linux/hw_breakpoint.h>
+#endif
+
+#define SETTLE_TICKS    (SHORT_TICKS * 3)
+
+static int failures = 0;     // 失败的检查数
+
+// 检查条件，失败时打印位置和说明并计数，不中断后续检查
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            failures++; \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+/**
+  * @brief  获取单调时钟（秒）
+  * @param  None
+  * @retval 当前时间
+  */
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+  * @brief  查找第一条指定类型的捕获事件
+  * @param  event: 事件类型
+  * @retval 事件记录，没有时返回 NULL
+  */
+static const MbSimEvent* find_event(ButtonEvent event)
+{
+    int n;
+    const MbSimEvent* ev = mb_sim_events(&n);
+
+    for (int i = 0; i < n; i++) {
+        if (ev[i].event == (uint8_t)event) return &ev[i];
+    }
+    return NULL;
+}
+
+/**
+  * @brief  按下时长扫描：从毛刺到远超长按阈值，每种时长按一次
+  * @param  None
+  * @retval None
+  */
+static void sweep_press_length(void)
+{
+    for (uint32_t p = 1; p <= LONG_TICKS * 2; p++) {
+        mb_sim_reset();
+        mb_sim_add(0, 1);
+        mb_sim_capture(MB_SIM_CAPTURE_ALL & ~(1u << BTN_LONG_PRESS_HOLD));
+        mb_sim_click(0, p, SETTLE_TICKS);
+
+        if (p < DEBOUNCE_TICKS) {
+            // 短于去抖滤波：必须完全忽略
+            CHECK(mb_sim_count(BTN_PRESS_DOWN) == 0, "glitch of %u ticks was not filtered", p);
+            continue;
+        }
+
+        // 长按在仍按住且经过时间首次超过 LONG_TICKS 的节拍触发；松开在按下 p 个节拍后被识别
+        int is_long = p > LONG_TICKS + 1;
+        const MbSimEvent* up = find_event(BTN_PRESS_UP);
+
+        CHECK(mb_sim_count(BTN_PRESS_DOWN) == 1, "press %u: %d PRESS_DOWN", p, mb_sim_count(BTN_PRESS_DOWN));
+        CHECK(up && up->duration == p, "press %u: PRESS_UP duration %u", p, up ? up->duration : 0);
+        CHECK(mb_sim_count(BTN_LONG_PRESS_START) == is_long, "press %u: %d long, expected %d", p,
+              mb_sim_count(BTN_LONG_PRESS_START), is_long);
+        CHECK(mb_sim_count(BTN_SINGLE_CLICK) == !is_long, "press %u: %d single, expected %d", p,
+              mb_sim_count(BTN_SINGLE_CLICK), !is_long);
+    }
+}
+
+/**
+  * @brief  点击间隔扫描：两次短按之间的间隔遍历双击窗口附近的每个值
+  * @param  None
+  * @retval None
+  */
+static void sweep_click_gap(void)
+{
+    for (uint32_t g = DEBOUNCE_TICKS; g <= SHORT_TICKS * 2; g++) {
+        mb_sim_reset();
+        mb_sim_add(0, 0);   // 低电平有效，覆盖电平换算
+        mb_sim_click(0, 5, g);
+        mb_sim_click(0, 5, SETTLE_TICKS);
+
+        // 再次按下先于点击超时判断，因此落在超过 SHORT_TICKS 后第一个节拍的按下仍算作第二次点击
+        int is_double = g <= SHORT_TICKS + 1;
+        const MbSimEvent* rep = find_event(BTN_PRESS_REPEAT);
+
+        CHECK(mb_sim_count(BTN_DOUBLE_CLICK) == is_double, "gap %u: %d double, expected %d", g,
+              mb_sim_count(BTN_DOUBLE_CLICK), is_double);
+        CHECK(mb_sim_count(BTN_SINGLE_CLICK) == (is_double ? 0 : 2), "gap %u: %d singles", g,
+              mb_sim_count(BTN_SINGLE_CLICK));
+        if (is_double) {
+            CHECK(rep && rep->duration == g, "gap %u: PRESS_REPEAT duration %u", g, rep ? rep->duration : 0);
+        }
+    }
+}
+
+/**
+  * @brief  弹跳扫描：按下和松开两个边沿都有弹跳时仍只产生一次单击
+  * @param  None
+  * @retval None
+  */
+static void sweep_bounce(void)
+{
+    for (uint8_t edges = 1; edges <= 9; edges += 2) {
+        for (uint32_t width = 1; width < DEBOUNCE_TICKS; width++) {
+            mb_sim_reset();
+            mb_sim_add(0, 1);
+            mb_sim_bounce(0, 1, edges, width);
+            mb_sim_press(0, 20);
+            mb_sim_bounce(0, 0, edges, width);
+            mb_sim_release(0, SETTLE_TICKS);
+
+            CHECK(mb_sim_count(BTN_PRESS_DOWN) == 1 && mb_sim_count(BTN_SINGLE_CLICK) == 1,
+                  "bounce %u x %u: %d down, %d single", edges, width,
+                  mb_sim_count(BTN_PRESS_DOWN), mb_sim_count(BTN_SINGLE_CLICK));
+        }
+    }
+}
+
+#if BUTTON_ENABLE_ENCODER
+static int detents[2];      // 各方向的定位格回调次数：[0] 逆时针，[1] 顺时针
+
+/**
+  * @brief  编码器回调：按方向计数
+  * @param  enc: 编码器
+  * @param  step: 方向（+1 顺时针，-1 逆时针）
+  * @retval None
+  */
+static void on_detent(ButtonEncoder* enc, int8_t step)
+{
+    (void)enc;
+    detents[step > 0]++;
+}
+
+/**
+  * @brief  编码器回调：在回调中停止编码器
+  * @param  enc: 编码器
+  * @param  step: 方向
+  * @retval None
+  */
+static void stop_on_detent(ButtonEncoder* enc, int8_t step)
+{
+    (void)step;
+    button_encoder_stop(enc);
+}
+
+/**
+  * @brief  编码器：正交解码、触点弹跳、转速估计以及在回调中停止
+  * @param  None
+  * @retval None
+  */
+static void sweep_encoder(void)
+{
+    ButtonEncoder enc;
+
+    // A/B 两相接虚拟 GPIO 10/11，每个定位格 4 次跳变，与一个按键一起采样
+    for (uint32_t width = 1; width <= 8; width++) {
+        mb_sim_reset();
+        mb_sim_add(0, 1);
+        detents[0] = detents[1] = 0;
+        button_encoder_init(&enc, mb_sim_read, 10, 11, 4);
+        button_encoder_attach(&enc, on_detent);
+        CHECK(button_encoder_start(&enc) == 0 && button_encoder_start(&enc) == -1, "encoder start");
+
+        mb_sim_turn(10, 11, 4 * 10, width);
+        mb_sim_turn(10, 11, -4 * 3, width);
+        mb_sim_click(0, 20, SETTLE_TICKS);
+        CHECK(button_encoder_get_position(&enc) == 7 && detents[1] == 10 && detents[0] == 3,
+              "encoder width %u: position %d, %d cw, %d ccw", width,
+              (int)button_encoder_get_position(&enc), detents[1], detents[0]);
+        CHECK(mb_sim_count(BTN_SINGLE_CLICK) == 1, "button next to encoder: %d single",
+              mb_sim_count(BTN_SINGLE_CLICK));
+        button_encoder_stop(&enc);
+    }
+
+    // 单相弹跳只在一次跳变附近来回：不产生定位格
+    mb_sim_reset();
+    button_encoder_init(&enc, mb_sim_read, 10, 11, 4);
+    button_encoder_start(&enc);
+    for (int i = 0; i < 9; i++) mb_sim_turn(10, 11, (i & 1) ? -1 : 1, 1);
+    mb_sim_turn(10, 11, -1, 1);
+    CHECK(button_encoder_get_position(&enc) == 0, "encoder bounce: position %d",
+          (int)button_encoder_get_position(&enc));
+
+    // 每 20 个节拍一个定位格，即每秒 1000 / (20 * TICKS_INTERVAL) 格
+    mb_sim_turn(10, 11, 4 * 8, 5);
+    CHECK(button_encoder_get_velocity(&enc) == (int32_t)(1000 / (20 * TICKS_INTERVAL)),
+          "encoder velocity %d", (int)button_encoder_get_velocity(&enc));
+    mb_sim_turn(10, 11, -4 * 8, 5);
+    CHECK(button_encoder_get_velocity(&enc) == -(int32_t)(1000 / (20 * TICKS_INTERVAL)),
+          "encoder reverse velocity %d", (int)button_encoder_get_velocity(&enc));
+    mb_sim_run(ENCODER_IDLE_TICKS + 1);
+    CHECK(button_encoder_get_velocity(&enc) == 0, "encoder idle velocity %d",
+          (int)button_encoder_get_velocity(&enc));
+    button_encoder_stop(&enc);
+
+    // 在回调中停止立即生效：之后的转动不再解码
+    button_encoder_attach(&enc, stop_on_detent);
+    button_encoder_start(&enc);
+    mb_sim_turn(10, 11, 4 * 3, 2);
+    CHECK(button_encoder_get_position(&enc) == 1 && enc.active == 0, "encoder stop in callback: position %d",
+          (int)button_encoder_get_position(&enc));
+}
+#endif
+
+#if BUTTON_ENABLE_SWITCH
+static int switch_events[2];     // 回调次数：[0] 断开，[1] 接通
+
+/**
+  * @brief  开关回调：按通断计数
+  * @param  sw: 开关
+  * @param  on: 1 接通，0 断开
+  * @retval None
+  */
+static void on_switch(ButtonSwitch* sw, uint8_t on)
+{
+    (void)sw;
+    switch_events[on ? 1 : 0]++;
+}
+
+/**
+  * @brief  开关模式：两个边沿都有弹跳时的去抖通断，不涉及点击时序
+  * @param  None
+  * @retval None
+  */
+static void sweep_switch(void)
+{
+    ButtonSwitch sw;
+
+    for (uint8_t edges = 1; edges <= 9; edges += 2) {
+        for (uint32_t width = 1; width < DEBOUNCE_TICKS; width++) {
+            // 虚拟 GPIO 20 在 mb_sim 中的有效电平为 0："按下"即拉低
+            mb_sim_reset();
+            mb_sim_set(20, 0);
+            switch_events[0] = switch_events[1] = 0;
+            button_switch_init(&sw, mb_sim_read, 0, 20);
+            button_switch_attach(&sw, on_switch);
+            CHECK(button_switch_start(&sw) == 0 && button_switch_is_on(&sw) == 0, "switch start");
+
+            mb_sim_bounce(20, 1, edges, width);
+            mb_sim_run(LONG_TICKS * 2);
+            CHECK(button_switch_is_on(&sw) == 1, "switch %u x %u: not on", edges, width);
+            mb_sim_bounce(20, 0, edges, width);
+            mb_sim_run(DEBOUNCE_TICKS);
+
+            CHECK(switch_events[1] == 1 && switch_events[0] == 1 && button_switch_is_on(&sw) == 0,
+                  "switch %u x %u: %d on, %d off", edges, width, switch_events[1], switch_events[0]);
+            button_switch_stop(&sw);
+        }
+    }
+
+    // 启动时已处于接通状态的自锁开关直接报告接通，不产生回调
+    mb_sim_reset();
+    mb_sim_set(20, 1);
+    switch_events[0] = switch_events[1] = 0;
+    button_switch_init(&sw, mb_sim_read, 0, 20);
+    button_switch_attach(&sw, on_switch);
+    button_switch_start(&sw);
+    mb_sim_run(SETTLE_TICKS);
+    CHECK(button_switch_is_on(&sw) == 1 && switch_events[0] + switch_events[1] == 0,
+          "latched switch: on %d, %d events", button_switch_is_on(&sw), switch_events[0] + switch_events[1]);
+    button_switch_stop(&sw);
+    CHECK(sw.active == 0 && button_switch_start(&sw) == 0, "switch restart");
+    button_switch_stop(&sw);
+}
+#endif
+
+#if BUTTON_ENABLE_LOGIC
+static uint32_t logic_reads;     // 逻辑按键引起的物理 HAL 读取次数
+static int logic_clicks[2];      // 各逻辑按键的单击次数
+
+/**
+  * @brief  计数的 HAL 读取函数
+  * @param  id: 虚拟 GPIO 编号
+  * @retval 当前电平
+  */
+static uint8_t count_read(uint8_t id)
+{
+    logic_reads++;
+    return mb_sim_read(id);
+}
+
+/**
+  * @brief  逻辑按键单击回调
+  * @param  btn: 逻辑按键
+  * @retval None
+  */
+static void on_logic_click(Button* btn)
+{
+    logic_clicks[btn->button_id]++;
+}
+
+/**
+  * @brief  逻辑按键 "A 且非 B" 与 "A 或 B"：各自独立的状态机，每个输入每节拍只读取一次
+  * @param  None
+  * @retval None
+  */
+static void sweep_logic(void)
+{
+    // 虚拟 GPIO 30/31 在 mb_sim 中的有效电平为 0："按下"即拉低
+    static const ButtonInput inputs[2] = { { count_read, 30, 0 }, { count_read, 31, 0 } };
+    static const ButtonLogic logic[2] = {
+        { 1u << 0, 1u << 1, 0 },            // A 且非 B
+        { 0, 0, (1u << 0) | (1u << 1) },    // A、B 任一
+    };
+    Button l[2];
+
+    mb_sim_reset();
+    mb_sim_set(30, 0);
+    mb_sim_set(31, 0);
+    CHECK(button_logic_init(inputs, 2, logic, 2) == 0, "logic init");
+    for (uint8_t i = 0; i < 2; i++) {
+        button_init(&l[i], button_logic_level, 1, i);
+        button_attach(&l[i], BTN_SINGLE_CLICK, on_logic_click);
+        button_start(&l[i]);
+    }
+    logic_clicks[0] = logic_clicks[1] = 0;
+    logic_reads = 0;
+
+    // 单独点击 A：两个表达式都产生单击
+    mb_sim_click(30, 20, SETTLE_TICKS);
+    // 按住 B 期间点击 A："且非" 看不到按下，"任一" 看到一次短按
+    mb_sim_press(31, 10);
+    mb_sim_click(30, 20, 10);
+    mb_sim_release(31, SETTLE_TICKS);
+
+    CHECK(logic_clicks[0] == 1 && logic_clicks[1] == 2, "logic clicks: %d and-not, %d any",
+          logic_clicks[0], logic_clicks[1]);
+    CHECK(logic_reads == 2 * mb_sim_now(), "logic reads: %u for %u ticks", logic_reads, mb_sim_now());
+    CHECK(button_logic_inputs() == 0, "logic snapshot 0x%x", button_logic_inputs());
+
+    for (uint8_t i = 0; i < 2; i++) button_stop(&l[i]);
+    button_logic_init(NULL, 0, NULL, 0);
+}
+#endif
+
+#if BUTTON_ENABLE_CALLBACKS
+static Button* deferred_btn[5];  // sweep_deferred() 的按键
+static uint32_t deferred_tick;   // 回调执行时的虚拟节拍
+static int deferred_seen;        // 回调中观察到的活动状态：位 n 为按键 n
+
+/**
+  * @brief  按下回调：停止自身、停止遍历中排在后面的按键、启动一个已停止的按键
+  * @param  btn: 按键
+  * @retval None
+  */
+static void restructure_on_press(Button* btn)
+{
+    deferred_tick = mb_sim_now();
+    button_stop(btn);
+    button_stop(deferred_btn[0]);
+    CHECK(button_start(deferred_btn[4]) == 0, "deferred start rejected");
+    for (int i = 0; i < 5; i++) deferred_seen |= button_is_active(deferred_btn[i]) << i;
+}
+
+/**
+  * @brief  回调中启动/停止按键：本节拍其余按键照常扫描，变更在节拍边界生效
+  * @param  None
+  * @retval None
+  *
+  * @note mb_sim_add() 把按键插入链表头部，链表遍历顺序为 3、2、1、0（遍历表按 button_id 排序，顺序为 0~3）；
+  *       按键 4 添加后先停止。检查不依赖遍历顺序
+  */
+static void sweep_deferred(void)
+{
+    const MbSimEvent* ev;
+    int n, pressed = 0;
+
+    mb_sim_reset();
+    for (uint8_t i = 0; i < 5; i++) deferred_btn[i] = mb_sim_add(i, 1);
+    button_stop(deferred_btn[4]);
+    button_attach(deferred_btn[3], BTN_PRESS_DOWN, restructure_on_press);
+    deferred_seen = 0;
+    deferred_tick = 0;
+
+    // 五个按键同时按下：在按键 3 的回调中修改工作集
+    for (uint8_t i = 0; i < 5; i++) mb_sim_set(i, 1);
+    mb_sim_run(DEBOUNCE_TICKS);
+    CHECK(deferred_tick == DEBOUNCE_TICKS && deferred_seen == 0x0f,
+          "deferred: callback at tick %u saw active mask 0x%x", deferred_tick, deferred_seen);
+
+    // 同一节拍内其余按键（包括刚被停止的按键 0）照常扫描
+    ev = mb_sim_events(&n);
+    CHECK(n == 3 && mb_sim_count(BTN_PRESS_DOWN) == 3, "deferred: %d events in the callback tick", n);
+    for (int i = 0; i < n; i++) {
+        pressed |= 1 << ev[i].button_id;
+        CHECK(ev[i].tick == deferred_tick, "deferred: event %d button %u tick %u", i, ev[i].button_id, ev[i].tick);
+    }
+    CHECK(pressed == 0x07, "deferred: pressed mask 0x%x in the callback tick", pressed);
+
+    // 节拍边界：按键 0、3 已停止，按键 4 从下一节拍开始扫描
+    CHECK(!button_is_active(deferred_btn[0]) && !button_is_active(deferred_btn[3]) &&
+          button_is_active(deferred_btn[4]) && button_is_active(deferred_btn[1]), "deferred: not applied at boundary");
+    mb_sim_run(DEBOUNCE_TICKS);
+    ev = mb_sim_events(&n);
+    CHECK(n == 4 && ev[3].button_id == 4 && ev[3].tick == deferred_tick + DEBOUNCE_TICKS,
+          "deferred: started button pressed at tick %u", n == 4 ? ev[3].tick : 0);
+
+    for (uint8_t i = 0; i < 5; i++) mb_sim_set(i, 0);
+    mb_sim_run(SETTLE_TICKS);
+    CHECK(mb_sim_count(BTN_SINGLE_CLICK) == 3 && mb_sim_count(BTN_PRESS_UP) == 3,
+          "deferred: %d clicks after release", mb_sim_count(BTN_SINGLE_CLICK));
+    ev = mb_sim_events(&n);
+    for (int i = 0; i < n; i++) {
+        CHECK(ev[i].button_id != 0 || ev[i].tick == deferred_tick, "deferred: stopped button 0 event at %u", ev[i].tick);
+    }
+}
+#endif
+
+#if BUTTON_ENABLE_POOL && BUTTON_ENABLE_CALLBACKS
+static ButtonPool pool;          // sweep_pool() 使用的按键池
+static int pool_destroy_rc;      // 回调中 button_destroy() 的返回值
+static int pool_active_in_cb;    // 回调中按键是否仍处于活动状态
+
+/**
+  * @brief  按下回调：在回调中销毁自身
+  * @param  btn: 按键
+  * @retval None
+  */
+static void destroy_on_press(Button* btn)
+{
+    pool_destroy_rc = button_destroy(&pool, btn);
+    pool_active_in_cb = button_is_active(btn);
+}
+
+/**
+  * @brief  静态按键池：耗尽、后进先出复用、重复释放、回调中销毁被推迟
+  * @param  None
+  * @retval None
+  */
+static void sweep_pool(void)
+{
+    Button storage[4];
+    Button* b[5];
+
+    // 虚拟 GPIO 40~43 按低电平有效使用：先置为松开
+    mb_sim_reset();
+    for (uint8_t i = 0; i < 4; i++) mb_sim_set(40 + i, 0);
+    CHECK(button_pool_init(&pool, storage, 0) == -2 && button_pool_init(&pool, storage, 4) == 0, "pool init");
+
+    // 耗尽：按数组顺序分配，满后返回 NULL
+    for (uint8_t i = 0; i < 5; i++) b[i] = button_create(&pool, mb_sim_read, 0, 40 + (i & 3));
+    CHECK(b[0] == &storage[0] && b[1] == &storage[1] && b[2] == &storage[2] && b[3] == &storage[3] &&
+          b[4] == NULL && pool.live == 4 && pool.used == 4, "pool exhaustion: live %u", pool.live);
+
+    // 后进先出：最近释放的槽位先被复用，高水位不变
+    CHECK(button_destroy(&pool, b[1]) == 0 && button_destroy(&pool, b[3]) == 0 && pool.live == 2, "pool destroy");
+    CHECK(button_create(&pool, mb_sim_read, 0, 43) == &storage[3] &&
+          button_create(&pool, mb_sim_read, 0, 41) == &storage[1] &&
+          button_create(&pool, mb_sim_read, 0, 44) == NULL && pool.used == 4, "pool LIFO reuse");
+
+    // 重复释放、不属于本池的指针：-2，计数不变
+    CHECK(button_destroy(&pool, b[2]) == 0 && button_destroy(&pool, b[2]) == -2 && pool.live == 3,
+          "pool double destroy: live %u", pool.live);
+    CHECK(button_destroy(&pool, &storage[0] + 4) == -2 &&
+          button_destroy(&pool, (Button*)((char*)&storage[0] + 1)) == -2 && pool.live == 3, "pool foreign handle");
+
+    // 活动按键在回调之外销毁：立即停止并释放
+    button_start(b[0]);
+    CHECK(button_destroy(&pool, b[0]) == 0 && !button_is_active(b[0]) && pool.live == 2, "pool destroy active");
+
+    // 回调中销毁：停止被推迟到本节拍遍历结束，返回 -1；同一节拍其余按键照常扫描
+    b[0] = button_create(&pool, mb_sim_read, 0, 40);
+    button_attach(b[0], BTN_PRESS_DOWN, destroy_on_press);
+    button_start(b[0]);
+    button_start(b[1]);
+    pool_destroy_rc = 0;
+    mb_sim_set(40, 1);
+    mb_sim_set(41, 1);
+    mb_sim_run(DEBOUNCE_TICKS);
+    CHECK(pool_destroy_rc == -1 && pool_active_in_cb == 1, "pool destroy in callback: %d, active %d",
+          pool_destroy_rc, pool_active_in_cb);
+    CHECK(!button_is_active(b[0]) && button_is_pressed(b[1]) == 1, "pool: deferred stop not applied");
+    CHECK(button_destroy(&pool, b[0]) == 0 && pool.live == 2, "pool destroy after deferred stop");
+
+    button_destroy(&pool, b[1]);
+    button_destroy(&pool, b[3]);
+    CHECK(pool.live == 0, "pool: %u live at end", pool.live);
+}
+#endif
+
+#if BUTTON_LAYOUT_SPLIT && BUTTON_SPLIT_DEFAULT_SLOTS
+static Button builtin_btn[BUTTON_SPLIT_DEFAULT_SLOTS + 1];   // sweep_split_builtin() 的按键，button_id 从 70 开始
+static ButtonSlot builtin_slots[BUTTON_SPLIT_DEFAULT_SLOTS + 1];
+
+/**
+  * @brief  分离布局内置遍历表：未调用 button_compact() 即可启动按键，满时返回 -3，
+  *         之后调用 button_compact() 迁移到更大的表并保留状态；停止后重新启动从空闲状态开始
+  * @param  None
+  * @retval None
+  *
+  * @note 必须在第一次 mb_sim_reset() 之前运行（mb_sim_reset() 会调用 button_compact()）；
+  *       虚拟 GPIO 70 起按低电平有效使用
+  */
+static void sweep_split_builtin(void)
+{
+    const uint8_t n = BUTTON_SPLIT_DEFAULT_SLOTS;
+
+    for (uint8_t i = 0; i <= n; i++) {
+        mb_sim_set(70 + i, 0);
+        button_init(&builtin_btn[i], mb_sim_read, 0, 70 + i);
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        CHECK(button_start(&builtin_btn[i]) == 0, "split builtin: start %u", i);
+    }
+    CHECK(button_start(&builtin_btn[n]) == -3, "split builtin: start beyond the built-in table");
+
+    mb_sim_set(70, 1);
+    mb_sim_run(DEBOUNCE_TICKS);
+    CHECK(button_is_pressed(&builtin_btn[0]) == 1, "split builtin: press not scanned");
+
+    // 迁移到调用者的数组：按住状态保留，容量扩大后可以继续启动
+    CHECK(button_compact(builtin_slots, n + 1) == n, "split builtin: compact");
+    CHECK(button_is_pressed(&builtin_btn[0]) == 1 && button_start(&builtin_btn[n]) == 0,
+          "split builtin: state or capacity lost in compact");
+
+    // 停止后热数据释放：仍按住的按键重新启动后从空闲状态开始，去抖后再次识别为按下
+    button_stop(&builtin_btn[0]);
+    CHECK(button_start(&builtin_btn[0]) == 0 && button_is_pressed(&builtin_btn[0]) == 0,
+          "split builtin: state kept across stop");
+    mb_sim_run(DEBOUNCE_TICKS);
+    CHECK(button_is_pressed(&builtin_btn[0]) == 1, "split builtin: restarted button not scanned");
+
+    mb_sim_set(70, 0);
+    for (uint8_t i = 0; i <= n; i++) button_stop(&builtin_btn[i]);
+}
+#endif
+
+#if BUTTON_LAYOUT_SPLIT && BUTTON_ENABLE_CALLBACKS && !BUTTON_ENABLE_CONCURRENT
+static Button full_btn[3];          // sweep_split_full() 的按键，button_id 为 80~82
+static ButtonSlot full_slots[3];    // sweep_split_full() 的遍历表：触发按键加 full_btn[0..1] 即满
+static int full_click;              // 触发按键已按下的次数
+static int full_ret[3];             // 回调中各次 button_start() 的返回值
+
+/**
+  * @brief  触发按键按下回调：表满时在回调中启动和停止按键
+  * @param  btn: 按键
+  * @retval None
+  */
+static void start_when_full(Button* btn)
+{
+    (void)btn;
+    if (++full_click == 1) {
+        // 表满：新按键立即失败；等待停止的按键重新启动只是撤销停止，不需要新表项
+        full_ret[0] = button_start(&full_btn[2]);
+        button_stop(&full_btn[0]);
+        full_ret[1] = button_start(&full_btn[0]);
+        button_stop(&full_btn[1]);
+    } else {
+        // 上一节拍停止释放了一个表项：第一个启动请求预留它，第二个失败
+        full_ret[0] = button_start(&full_btn[2]);
+        full_ret[2] = button_start(&full_btn[1]);
+    }
+}
+
+/**
+  * @brief  分离布局表满时在回调中启动按键：button_start() 与直接调用一样返回 -3，而不是返回 0 却从未启动
+  * @param  None
+  * @retval None
+  */
+static void sweep_split_full(void)
+{
+    Button* trigger;
+
+    mb_sim_reset();
+    CHECK(button_compact(full_slots, 3) == 0, "split full: compact");
+    trigger = mb_sim_add(0, 1);
+    button_attach(trigger, BTN_PRESS_DOWN, start_when_full);
+    for (uint8_t i = 0; i < 3; i++) {
+        mb_sim_set(80 + i, 0);
+        button_init(&full_btn[i], mb_sim_read, 0, 80 + i);
+    }
+    CHECK(button_start(&full_btn[0]) == 0 && button_start(&full_btn[1]) == 0 &&
+          button_start(&full_btn[2]) == -3, "split full: table not full");
+    full_click = 0;
+
+    mb_sim_click(0, 5, 5);
+    CHECK(full_ret[0] == -3 && full_ret[1] == 0, "split full: start in callback returned %d, restart %d",
+          full_ret[0], full_ret[1]);
+    CHECK(button_is_active(&full_btn[0]) && !button_is_active(&full_btn[1]) && !button_is_active(&full_btn[2]),
+          "split full: active %d %d %d", button_is_active(&full_btn[0]), button_is_active(&full_btn[1]),
+          button_is_active(&full_btn[2]));
+
+    mb_sim_click(0, 5, SETTLE_TICKS);
+    CHECK(full_click == 2 && full_ret[0] == 0 && full_ret[2] == -3,
+          "split full: reserved start returned %d, second %d", full_ret[0], full_ret[2]);
+    CHECK(button_is_active(&full_btn[2]) && !button_is_active(&full_btn[1]), "split full: reserved start not applied");
+
+    for (uint8_t i = 0; i < 3; i++) button_stop(&full_btn[i]);
+}
+#endif
+
+#if !BUTTON_ENABLE_CONCURRENT
+static Button batch_btn[6];          // sweep_batch() 的按键，button_id 为 50~55
+#if BUTTON_ENABLE_COMPACT
+static ButtonSlot batch_slots[8];    // sweep_batch() 自备的遍历表
+#endif
+
+/**
+  * @brief  批量注册：重复启动被跳过、批量停止与单个停止混用、遍历表模式下批量启动后表保持有序
+  * @param  None
+  * @retval None
+  *
+  * @note 虚拟 GPIO 50~55 按低电平有效使用（与 mb_sim 复位后的有效电平一致）
+  */
+static void sweep_batch(void)
+{
+    int pressed = 0;
+
+    mb_sim_reset();
+    for (uint8_t i = 0; i < 6; i++) mb_sim_set(50 + i, 0);
+    CHECK(button_init_batch(batch_btn, 6, NULL, 0, 50, NULL) == -2 &&
+          button_init_batch(batch_btn, 6, mb_sim_read, 0, 50, NULL) == 0, "batch init");
+
+    // 重复启动：已在工作链表中的按键按 active 标记跳过
+    CHECK(button_start_batch(batch_btn, 4) == 4, "batch start");
+    CHECK(button_start_batch(batch_btn, 6) == 2 && button_start_batch(batch_btn, 6) == 0 &&
+          button_start(&batch_btn[0]) == -1, "batch start: duplicates not rejected");
+
+    // 批量停止与单个停止混用：已停止的按键不计数，删除标记不残留
+    button_stop(&batch_btn[1]);
+    CHECK(button_stop_batch(batch_btn, 4) == 3, "batch stop: count with a single stop mixed in");
+    button_stop(&batch_btn[5]);
+    CHECK(button_stop_batch(batch_btn, 4) == 0, "batch stop: stopped buttons counted twice");
+    for (uint8_t i = 0; i < 6; i++) {
+        CHECK(button_is_active(&batch_btn[i]) == (i == 4), "batch stop: button %u active %d", i,
+              button_is_active(&batch_btn[i]));
+    }
+    CHECK(button_start(&batch_btn[1]) == 0, "batch stop: button 1 cannot restart");
+
+    for (uint8_t i = 0; i < 6; i++) mb_sim_set(50 + i, 1);
+    mb_sim_run(DEBOUNCE_TICKS);
+    for (uint8_t i = 0; i < 6; i++) pressed |= (button_is_pressed(&batch_btn[i]) == 1) << i;
+    CHECK(pressed == 0x12, "batch stop: pressed mask 0x%x", pressed);
+    for (uint8_t i = 0; i < 6; i++) mb_sim_set(50 + i, 0);
+    mb_sim_run(SETTLE_TICKS);
+    button_stop_batch(batch_btn, 6);
+
+#if BUTTON_ENABLE_COMPACT
+    // 遍历表模式：先启动后半段，再批量启动前半段，整表按 button_id 重新排序而不是拼接在末尾
+    CHECK(button_compact(batch_slots, 8) == 0, "batch: compact");
+    CHECK(button_start_batch(batch_btn + 3, 3) == 3 && button_start_batch(batch_btn, 3) == 3, "batch start in compact mode");
+    for (uint8_t i = 0; i < 6; i++) {
+        CHECK(batch_slots[i].handle == &batch_btn[i] && batch_slots[i].button_id == 50 + i,
+              "batch compact: slot %u holds button %u", i, batch_slots[i].button_id);
+    }
+    mb_sim_set(50, 1);
+    mb_sim_run(DEBOUNCE_TICKS);
+    CHECK(button_is_pressed(&batch_btn[0]) == 1, "batch compact: re-sorted table not scanned");
+    mb_sim_set(50, 0);
+    mb_sim_run(SETTLE_TICKS);
+
+    // 还原：停止后关闭遍历表（分离布局下返回 -2，由下一次 mb_sim_reset() 重建）
+    CHECK(button_stop_batch(batch_btn, 6) == 6, "batch: final stop");
+    button_compact(NULL, 0);
+#endif
+}
+#endif
+
+#if BUTTON_ENABLE_TWO_PHASE && BUTTON_ENABLE_CALLBACKS
+static uint32_t snapshot_tick;   // 按键 0 按下回调执行时的虚拟节拍
+static uint8_t port_bits;        // sweep_sampler() 的虚拟端口：位 n 为按键 n 的电平
+static uint32_t sampler_calls;   // 采样函数调用次数
+static uint16_t sampler_count;   // 最近一次采样的表项数
+static uint8_t custom_levels[4]; // sweep_sampler() 的采样缓冲区
+
+/**
+  * @brief  按键 0 按下回调：在状态机阶段修改按键 1 的虚拟 GPIO
+  * @param  btn: 按键
+  * @retval None
+  */
+static void press_neighbour(Button* btn)
+{
+    (void)btn;
+    snapshot_tick = mb_sim_now();
+    mb_sim_set(1, 1);
+}
+
+/**
+  * @brief  两阶段快照：回调在状态机阶段改变另一按键的电平，该按键本节拍仍使用节拍开始时的采样
+  * @param  None
+  * @retval None
+  *
+  * @note 遍历表按 button_id 排序，按键 1 在按键 0 之后处理；逐个读取时它会在同一节拍读到新电平
+  */
+static void sweep_snapshot(void)
+{
+    Button* b0;
+    const MbSimEvent* down;
+
+    mb_sim_reset();
+    b0 = mb_sim_add(0, 1);
+    mb_sim_add(1, 1);
+    button_attach(b0, BTN_PRESS_DOWN, press_neighbour);
+    snapshot_tick = 0;
+
+    mb_sim_press(0, DEBOUNCE_TICKS);
+    CHECK(snapshot_tick == DEBOUNCE_TICKS, "snapshot: callback at tick %u", snapshot_tick);
+    mb_sim_run(DEBOUNCE_TICKS);
+    down = find_event(BTN_PRESS_DOWN);
+    CHECK(down && down->button_id == 1 && down->tick == snapshot_tick + DEBOUNCE_TICKS,
+          "snapshot: button 1 pressed at tick %u, expected %u", down ? down->tick : 0,
+          snapshot_tick + DEBOUNCE_TICKS);
+}
+
+/**
+  * @brief  自定义采样函数：从虚拟端口按 button_id 拆分电平，不调用 HAL 函数
+  * @param  levels: 采样缓冲区
+  * @param  slots: 遍历表
+  * @param  count: 表项数
+  * @retval None
+  */
+static void port_sampler(uint8_t* levels, const ButtonSlot* slots, uint16_t count)
+{
+    sampler_calls++;
+    sampler_count = count;
+    for (uint16_t i = 0; i < count; i++) {
+        levels[i] = (port_bits >> slots[i].button_id) & 1;
+    }
+}
+
+/**
+  * @brief  自定义采样函数：每节拍调用一次，状态机只使用其写入的电平
+  * @param  None
+  * @retval None
+  */
+static void sweep_sampler(void)
+{
+    mb_sim_reset();
+    mb_sim_add(0, 1);
+    mb_sim_add(2, 1);
+    port_bits = 0;
+    sampler_calls = 0;
+    CHECK(button_set_sampler(custom_levels, 0, port_sampler) == -2 &&
+          button_set_sampler(custom_levels, 4, port_sampler) == 0, "sampler: set");
+
+    // 虚拟 GPIO 一直松开，只有端口位 2 按下：事件只能来自采样函数
+    port_bits = 1 << 2;
+    mb_sim_run(DEBOUNCE_TICKS);
+    CHECK(sampler_calls == DEBOUNCE_TICKS && sampler_count == 2, "sampler: %u calls, %u slots",
+          sampler_calls, sampler_count);
+    CHECK(mb_sim_count(BTN_PRESS_DOWN) == 1 && find_event(BTN_PRESS_DOWN)->button_id == 2,
+          "sampler: %d PRESS_DOWN", mb_sim_count(BTN_PRESS_DOWN));
+
+    port_bits = 0;
+    mb_sim_run(SETTLE_TICKS);
+    CHECK(mb_sim_count(BTN_SINGLE_CLICK) == 1, "sampler: %d clicks", mb_sim_count(BTN_SINGLE_CLICK));
+}
+
+#if BUTTON_ENABLE_ENCODER && BUTTON_ENABLE_SWITCH
+/**
+  * @brief  按键 0 按下回调：在状态机阶段转动编码器一个相位并接通开关
+  * @param  btn: 按键
+  * @retval None
+  */
+static void turn_neighbours(Button* btn)
+{
+    (void)btn;
+    snapshot_tick = mb_sim_now();
+    mb_sim_set(10, 0);      // 未登记为按键的虚拟 GPIO 有效电平为 0：A 相变为 1
+    mb_sim_set(20, 0);
+}
+
+/**
+  * @brief  编码器和开关属于同一份快照：状态机阶段的电平变化在下一节拍才被扫描到
+  * @param  None
+  * @retval None
+  */
+static void sweep_aux_snapshot(void)
+{
+    ButtonEncoder enc;
+    ButtonSwitch sw;
+    Button* b0;
+
+    mb_sim_reset();
+    b0 = mb_sim_add(0, 1);
+    button_attach(b0, BTN_PRESS_DOWN, turn_neighbours);
+    button_encoder_init(&enc, mb_sim_read, 10, 11, 4);
+    button_encoder_start(&enc);
+    button_switch_init(&sw, mb_sim_read, 1, 20);
+    button_switch_start(&sw);
+    snapshot_tick = 0;
+
+    mb_sim_press(0, DEBOUNCE_TICKS);
+    CHECK(snapshot_tick == DEBOUNCE_TICKS && enc.ab == 0 && sw.debounce_cnt == 0,
+          "aux snapshot: phase %u, switch count %u at tick %u", enc.ab, sw.debounce_cnt, snapshot_tick);
+    mb_sim_run(1);
+    CHECK(enc.ab == 2 && sw.debounce_cnt == 1, "aux snapshot: next tick phase %u, switch count %u",
+          enc.ab, sw.debounce_cnt);
+
+    button_encoder_stop(&enc);
+    button_switch_stop(&sw);
+}
+#endif
+#endif
+
+#if defined(__linux__)
+/**
+  * @brief  打开硬件观察点（perf_event_open），计数一段内存被访问的次数
+  * @param  addr: 起始地址（按 len 对齐）
+  * @param  len: 长度（1、2、4 或 8 字节）
+  * @param  type: HW_BREAKPOINT_W 只计写入，HW_BREAKPOINT_RW 计读写
+  * @retval 描述符，不支持时返回 -1
+  */
+static int watch_open(const volatile void* addr, uint32_t len, uint32_t type)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_BREAKPOINT;
+    attr.size = sizeof(attr);
+    attr.bp_type = type;
+    attr.bp_addr = (uintptr_t)addr;
+    attr.bp_len = len;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+  * @brief  读取观察点计数
+  * @param  fd: 描述符
+  * @retval 访问次数
+  */
+static long long watch_count(int fd)
+{
+    long long count = 0;
+
+    if (read(fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) return -1;
+    return count;
+}
+
+/**
+  * @brief  电平稳定的按键每节拍不写热数据：空闲、按住未到长按、长按保持三种情况下观察点计数为 0
+  * @param  None
+  * @retval None
+  *
+  * @note 观察 state_tick 起的 8 个字节：进入时刻和全部位域（去抖计数、事件、状态等）
+  */
+static void sweep_hot_stores(void)
+{
+    const uint32_t ticks = 40;
+    const volatile void* hot;
+    long long base, stores;
+    Button* btn;
+    int fd;
+
+    mb_sim_reset();
+    btn = mb_sim_add(0, 1);
+#if BUTTON_LAYOUT_SPLIT
+    hot = &btn->slot->state_tick;
+#else
+    hot = &btn->state_tick;
+#endif
+    mb_sim_run(SETTLE_TICKS);
+
+    fd = watch_open(hot, 8, HW_BREAKPOINT_W);
+    if (fd < 0) {
+        printf("Hot-data store count skipped: hardware watchpoints unavailable\n");
+        return;
+    }
+
+    base = watch_count(fd);
+    mb_sim_run(ticks);
+    stores = watch_count(fd) - base;
+    CHECK(stores == 0, "idle button: %lld stores in %u ticks", stores, ticks);
+
+    mb_sim_press(0, DEBOUNCE_TICKS + 1);
+    base = watch_count(fd);
+    mb_sim_run(LONG_TICKS / 2);
+    stores = watch_count(fd) - base;
+    CHECK(stores == 0, "pressed button: %lld stores in %u ticks", stores, LONG_TICKS / 2);
+
+    mb_sim_run(LONG_TICKS);
+    base = watch_count(fd);
+    mb_sim_run(ticks);
+    stores = watch_count(fd) - base;
+    CHECK(stores == 0 && button_get_event(btn) == BTN_LONG_PRESS_HOLD,
+          "long hold: %lld stores in %u ticks, event %d", stores, ticks, (int)button_get_event(btn));
+
+    // 观察点确实计到写入：松开后的去抖和状态切换必然写热数据
+    mb_sim_release(0, SETTLE_TICKS);
+    CHECK(watch_count(fd) - base > 0, "hot-data watchpoint saw no stores");
+    close(fd);
+}
+#endif
+
+#if BUTTON_ENABLE_MMIO && BUTTON_ENABLE_COMPACT && defined(__linux__)
+static volatile ButtonInputWord mmio_port[2];  // 两个输入字，由硬件观察点统计访问次数
+static Button mmio_btn[8];                     // sweep_mmio_loads() 的按键，交替绑定两个字
+static ButtonSlot mmio_slots[8];               // sweep_mmio_loads() 的遍历表
+
+/**
+  * @brief  内存映射输入：button_compact() 之后每个输入字每节拍只加载一次
+  * @param  None
+  * @retval None
+  *
+  * @note 按键交替绑定两个字并按 0~7 启动，链表遍历顺序 7~0 中相邻按键属于不同的字，
+  *       每个字每节拍加载 4 次；遍历表按输入字排序后同一字的按键相邻，只加载 1 次
+  */
+static void sweep_mmio_loads(void)
+{
+    const uint32_t ticks = 50;
+    long long base[2], loads[2];
+    int fd[2];
+
+    mb_sim_reset();
+    mmio_port[0] = 1;   // 按键 0（字 0 位 0）按下，其余松开
+    mmio_port[1] = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        button_init_mmio(&mmio_btn[i], &mmio_port[i & 1], (ButtonInputWord)(1u << (i >> 1)), 1, 60 + i);
+        button_start(&mmio_btn[i]);
+    }
+
+    // x86 不支持只读观察点，计读写；计数期间测试不写输入字
+    fd[0] = watch_open(&mmio_port[0], sizeof(ButtonInputWord), HW_BREAKPOINT_RW);
+    fd[1] = watch_open(&mmio_port[1], sizeof(ButtonInputWord), HW_BREAKPOINT_RW);
+    if (fd[0] < 0 || fd[1] < 0) {
+        printf("MMIO load count skipped: hardware watchpoints unavailable\n");
+    } else {
+#if !BUTTON_LAYOUT_SPLIT && !BUTTON_ENABLE_TWO_PHASE
+        // 链表遍历：同一字的按键不相邻，核对观察点确实计到每一次加载
+        for (int w = 0; w < 2; w++) base[w] = watch_count(fd[w]);
+        mb_sim_run(ticks);
+        for (int w = 0; w < 2; w++) {
+            loads[w] = watch_count(fd[w]) - base[w];
+            CHECK(loads[w] == 4 * (long long)ticks, "mmio list: word %d loaded %lld times in %u ticks", w, loads[w], ticks);
+        }
+#endif
+
+        CHECK(button_compact(mmio_slots, 8) == 8, "mmio: compact");
+        for (int w = 0; w < 2; w++) base[w] = watch_count(fd[w]);
+        mb_sim_run(ticks);
+        for (int w = 0; w < 2; w++) {
+            loads[w] = watch_count(fd[w]) - base[w];
+            CHECK(loads[w] == (long long)ticks, "mmio compact: word %d loaded %lld times in %u ticks", w, loads[w], ticks);
+        }
+        CHECK(button_is_pressed(&mmio_btn[0]) == 1 && button_is_pressed(&mmio_btn[1]) == 0, "mmio: levels");
+    }
+    if (fd[0] >= 0) close(fd[0]);
+    if (fd[1] >= 0) close(fd[1]);
+
+    for (uint8_t i = 0; i < 8; i++) button_stop(&mmio_btn[i]);
+    button_compact(NULL, 0);
+}
+#endif
+
+#if BUTTON_ENABLE_BUDGET_SCAN
+/**
+  * @brief  以固定按键数预算推进若干节拍
+  * @param  calls: 调用 button_ticks_budget() 的次数
+  * @param  budget: 每次最多服务的按键数
+  * @retval 服务的按键总数
+  */
+static int budget_run(int calls, uint16_t budget)
+{
+    int served = 0;
+
+    while (calls--) served += button_ticks_budget(budget, NULL, 0);
+    return served;
+}
+
+/**
+  * @brief  限时增量扫描：一轮跨越多个节拍时的统计，以及扫描途中启动/停止按键
+  * @param  None
+  * @retval None
+  */
+static void sweep_budget(void)
+{
+    ButtonScanStats st;
+    Button* b[6];
+    uint32_t rounds;
+    int served;
+
+    // 5 个按键，每节拍 2 个：一轮 3 个节拍（2 + 2 + 1）
+    mb_sim_reset();
+    for (uint8_t i = 0; i < 5; i++) b[i] = mb_sim_add(i, 1);
+    button_scan_stats(&st);
+    rounds = st.rounds;
+    CHECK(st.lag == 0 && st.position == 0, "budget: round in progress after reset");
+
+    served = budget_run(1, 2);
+    button_scan_stats(&st);
+    CHECK(served == 2 && st.lag == 1 && st.position == 2 && st.rounds == rounds,
+          "budget: first call served %d, lag %u, position %u", served, st.lag, st.position);
+    served += budget_run(2, 2);
+    button_scan_stats(&st);
+    CHECK(served == 5 && st.rounds == rounds + 1 && st.round_ticks == 3 && st.lag == 0,
+          "budget: round of %d buttons, %u rounds, %u ticks", served, st.rounds - rounds, st.round_ticks);
+
+    // 扫描途中启动：新按键插入链表头部，按已服务个数重新定位，本轮仍在 3 个节拍内结束
+    budget_run(1, 2);
+    b[5] = mb_sim_add(5, 1);
+    budget_run(2, 2);
+    button_scan_stats(&st);
+    CHECK(st.rounds == rounds + 2 && st.round_ticks == 3 && st.lag == 0,
+          "budget: start mid-round: %u rounds, %u ticks", st.rounds - rounds, st.round_ticks);
+    served = budget_run(3, 2);
+    button_scan_stats(&st);
+    CHECK(served == 6 && st.rounds == rounds + 3 && st.round_ticks == 3,
+          "budget: 6 buttons served %d in %u ticks", served, st.round_ticks);
+
+    // 全部按下：每个按键每 3 个节拍服务一次，去抖按服务次数计数
+    for (uint8_t i = 0; i < 6; i++) mb_sim_set(i, 1);
+    budget_run(3 * DEBOUNCE_TICKS, 2);
+    CHECK(mb_sim_count(BTN_PRESS_DOWN) == 6, "budget: %d PRESS_DOWN after %d ticks",
+          mb_sim_count(BTN_PRESS_DOWN), 3 * DEBOUNCE_TICKS);
+    for (uint8_t i = 0; i < 6; i++) mb_sim_set(i, 0);
+    budget_run(3 * (SHORT_TICKS + DEBOUNCE_TICKS), 2);
+    CHECK(mb_sim_count(BTN_SINGLE_CLICK) == 6, "budget: %d SINGLE_CLICK", mb_sim_count(BTN_SINGLE_CLICK));
+
+    // 扫描途中停止尚未服务的按键：本轮服务其余全部按键
+    button_scan_stats(&st);
+    rounds = st.rounds;
+    served = budget_run(1, 2);
+    button_stop(b[2]);
+    served += budget_run(2, 2);
+    button_scan_stats(&st);
+    CHECK(served == 5 && st.rounds == rounds + 1 && st.round_ticks == 3,
+          "budget: stop mid-round served %d in %u ticks", served, st.round_ticks);
+
+    // 停止已服务的按键：其后的按键前移一位，本轮跳过一个，提前结束
+    rounds = st.rounds;
+    budget_run(1, 2);
+    button_stop(b[5]);
+    served = budget_run(1, 2);
+    button_scan_stats(&st);
+    CHECK(served == 2 && st.rounds == rounds + 1 && st.round_ticks == 2,
+          "budget: stop served button: %d served, %u ticks", served, st.round_ticks);
+
+    // 游标越过缩短后的末尾：结束本轮并在同一节拍开始下一轮，不会空转一个节拍
+    budget_run(1, 2);
+    button_stop(b[1]);
+    button_stop(b[0]);
+    served = budget_run(1, 2);
+    button_scan_stats(&st);
+    CHECK(served == 2 && st.rounds == rounds + 3 && st.round_ticks == 1 && st.lag == 0,
+          "budget: cursor past end: %d served, %u rounds", served, st.rounds - rounds);
+
+    // 扫描途中停止全部按键：本轮结束，之后没有可服务的按键
+    budget_run(1, 1);
+    button_stop(b[3]);
+    button_stop(b[4]);
+    served = budget_run(2, 2);
+    button_scan_stats(&st);
+    CHECK(served == 0 && st.rounds == rounds + 4 && st.lag == 0 && st.position == 0,
+          "budget: empty working set: %d served, lag %u", served, st.lag);
+}
+#endif
+
+#if BUTTON_EVENT_RING_SIZE
+// 订阅者最多可落后的条数：生产者可能与读取同时运行时最旧的槽位不可用（与库中的界限一致）
+#if BUTTON_ENABLE_CONCURRENT || BUTTON_ENABLE_EVENTFD
+#define RING_USABLE     (BUTTON_EVENT_RING_SIZE - 1)
+#else
+#define RING_USABLE     BUTTON_EVENT_RING_SIZE
+#endif
+
+/**
+  * @brief  读空内置消费者的事件缓冲区
+  * @param  None
+  * @retval 读取的条数
+  */
+static int drain_ring(void)
+{
+    ButtonEventRecord buf[8];
+    int n, total = 0;
+
+    while ((n = button_event_read(buf, 8)) > 0) total += n;
+    return total;
+}
+
+/**
+  * @brief  事件环形缓冲区：记录内容与回调一致，溢出后丢弃最旧的事件并计数；eventfd 每节拍最多写一次
+  * @param  None
+  * @retval None
+  */
+static void sweep_ring(void)
+{
+    ButtonEventRecord recs[RING_USABLE];
+    const MbSimEvent* ev;
+    uint32_t base, dropped;
+    int n, count;
+
+    mb_sim_reset();
+    mb_sim_add(0, 1);
+    mb_sim_add(1, 0);
+    drain_ring();
+    dropped = button_event_dropped();
+    base = button_get_tick() - mb_sim_now();
+
+    // 双击 + 短按：记录的按键、事件、节拍、重复次数、时长与回调捕获的逐条一致
+    mb_sim_click(0, 10, 20);
+    mb_sim_press(1, 5);
+    mb_sim_click(0, 15, 5);
+    mb_sim_release(1, SETTLE_TICKS);
+    ev = mb_sim_events(&count);
+    n = button_event_read(recs, RING_USABLE);
+    CHECK(n == count && count > 0 && count < RING_USABLE, "ring: %d records, %d captured", n, count);
+    for (int i = 0; i < n && i < count; i++) {
+        CHECK(recs[i].button->button_id == ev[i].button_id && recs[i].event == ev[i].event &&
+              recs[i].tick - base == ev[i].tick && recs[i].repeat == ev[i].repeat &&
+              recs[i].duration == ev[i].duration,
+              "ring record %d: button %u event %u tick %u repeat %u duration %u", i,
+              recs[i].button->button_id, recs[i].event, recs[i].tick - base, recs[i].repeat, recs[i].duration);
+    }
+    CHECK(button_event_dropped() == dropped, "ring: %u dropped without overflow", button_event_dropped() - dropped);
+
+    // 溢出：读取到的是最新的 RING_USABLE 条，其余计入丢失
+    mb_sim_press(0, LONG_TICKS + 10);
+    drain_ring();
+    mb_sim_run(RING_USABLE + 5);
+    n = button_event_read(recs, RING_USABLE);
+    CHECK(n == RING_USABLE && button_event_dropped() - dropped == 5 && recs[0].tick == button_get_tick() - RING_USABLE + 1 &&
+          recs[n - 1].tick == button_get_tick() && recs[n - 1].event == BTN_LONG_PRESS_HOLD,
+          "ring overflow: %d read, %u dropped", n, button_event_dropped() - dropped);
+    CHECK(button_event_read(recs, RING_USABLE) == 0, "ring: events left after overflow");
+
+#if BUTTON_ENABLE_EVENTFD
+    {
+        int fd = button_eventfd_open();
+        uint64_t writes;
+        int events;
+
+        CHECK(fd >= 0 && button_eventfd_open() == fd, "eventfd open");
+
+        // 两个按键同时长按：每节拍两条事件，只写一次；松开后没有事件的节拍不写
+        mb_sim_press(1, LONG_TICKS + 10);
+        drain_ring();
+        while (button_eventfd_drain(recs, RING_USABLE) > 0) {}
+        for (int t = 0; t < SETTLE_TICKS * 2; t++) {
+            if (t == SETTLE_TICKS) {
+                mb_sim_set(0, 0);
+                mb_sim_set(1, 0);
+            }
+            mb_sim_run(1);
+            if (read(fd, &writes, sizeof(writes)) != sizeof(writes)) writes = 0;
+            events = 0;
+            while ((n = button_eventfd_drain(recs, RING_USABLE)) > 0) events += n;
+            CHECK(writes == (events > 0), "eventfd tick %d: %u writes, %d events", t, (unsigned)writes, events);
+            if (t < SETTLE_TICKS) CHECK(events == 2, "eventfd tick %d: %d events", t, events);
+        }
+
+        // 消费者未取走前不重复通知
+        mb_sim_press(0, LONG_TICKS + 10);
+        writes = 0;
+        CHECK(read(fd, &writes, sizeof(writes)) == sizeof(writes) && writes == 1,
+              "eventfd: %u writes while not drained", (unsigned)writes);
+        drain_ring();
+        button_eventfd_drain(recs, RING_USABLE);
+        mb_sim_release(0, SETTLE_TICKS);
+        button_eventfd_close();
+        CHECK(button_eventfd() == -1, "eventfd close");
+    }
+#endif
+}
+
+/**
+  * @brief  读完订阅者的全部未读事件，检查节拍连续
+  * @param  sub: 订阅者
+  * @param  first_tick: 输出第一条记录的节拍（无记录时不修改）
+  * @retval 读取的条数；节拍不连续或有记录被判定为覆盖时返回 -1
+  */
+static int drain_subscriber(ButtonSubscriber* sub, uint32_t* first_tick)
+{
+    const ButtonEventRecord* recs;
+    uint32_t next = 0;
+    int n, total = 0;
+
+    while ((recs = button_subscriber_peek(sub, &n)) != NULL) {
+        for (int i = 0; i < n; i++) {
+            if (total == 0 && i == 0) *first_tick = next = recs[0].tick;
+            if (recs[i].tick != next++) return -1;
+        }
+        if (button_subscriber_commit(sub, n) != 0) return -1;
+        total += n;
+    }
+    return total;
+}
+
+/**
+  * @brief  多消费者订阅：原地读取、回绕、lag_max、恰好落后可用容量时不误报覆盖、溢出与处理期间覆盖的计数
+  * @param  None
+  * @retval None
+  *
+  * @note 长按保持期间每节拍恰好产生一条 BTN_LONG_PRESS_HOLD，用来精确控制事件条数
+  */
+static void sweep_subscriber(void)
+{
+    ButtonSubscriber sub, other;
+    const ButtonEventRecord* recs;
+    const ButtonEventRecord* seg;
+    uint32_t first = 0, now;
+    int n, torn, total;
+
+    mb_sim_reset();
+    mb_sim_add(0, 1);
+    mb_sim_press(0, LONG_TICKS + 10);
+
+    // 游标停在缓冲区末尾前两条，使接下来的 5 条事件跨过回绕点
+    do {
+        mb_sim_run(1);
+        button_subscriber_init(&sub);
+    } while ((sub.cursor & (BUTTON_EVENT_RING_SIZE - 1)) != BUTTON_EVENT_RING_SIZE - 2);
+    button_subscriber_init(&other);
+    CHECK(button_subscriber_peek(&sub, &n) == NULL, "subscriber: events before any tick");
+
+    mb_sim_run(5);
+    now = button_get_tick();
+    recs = button_subscriber_peek(&sub, &n);
+    CHECK(recs && n == 2 && recs[0].tick == now - 4 && recs[1].tick == now - 3 &&
+          recs[0].event == BTN_LONG_PRESS_HOLD, "subscriber: first segment %d", n);
+    CHECK(button_subscriber_commit(&sub, n) == 0, "subscriber: first commit torn");
+    seg = recs;
+    recs = button_subscriber_peek(&sub, &n);
+    CHECK(recs && recs < seg && n == 3 && recs[0].tick == now - 2, "subscriber: wrapped segment %d", n);
+    CHECK(button_subscriber_commit(&sub, n) == 0 && button_subscriber_lag(&sub) == 0 && sub.lag_max == 5,
+          "subscriber: lag %u, lag_max %u", button_subscriber_lag(&sub), sub.lag_max);
+
+    // 订阅者之间互不影响
+    CHECK(button_subscriber_lag(&other) == 5 && drain_subscriber(&other, &first) == 5 && other.overruns == 0,
+          "subscriber: second reader lag %u", button_subscriber_lag(&other));
+
+    // 恰好落后可用容量：全部有效，不计覆盖
+    mb_sim_run(RING_USABLE);
+    total = drain_subscriber(&sub, &first);
+    CHECK(total == RING_USABLE && sub.overruns == 0 && first == button_get_tick() - RING_USABLE + 1,
+          "subscriber: %d of %d at capacity, %u overruns", total, RING_USABLE, sub.overruns);
+
+    // 落后超过可用容量：跳过最旧的记录，从仍然有效的最旧记录继续
+    mb_sim_run(RING_USABLE + 3);
+    total = drain_subscriber(&sub, &first);
+    CHECK(total == RING_USABLE && sub.overruns == 3 && first == button_get_tick() - RING_USABLE + 1,
+          "subscriber: %d after overflow, %u overruns", total, sub.overruns);
+    CHECK(sub.lag_max == RING_USABLE, "subscriber: lag_max %u", sub.lag_max);
+
+    // 处理期间生产者追上：commit 只报告真正被覆盖的记录
+    mb_sim_run(2);
+    recs = button_subscriber_peek(&sub, &n);
+    mb_sim_run(RING_USABLE - 2);
+    CHECK(recs && button_subscriber_commit(&sub, n) == 0, "subscriber: false torn report at capacity");
+    drain_subscriber(&sub, &first);
+
+    mb_sim_run(2);
+    recs = button_subscriber_peek(&sub, &n);
+    mb_sim_run(RING_USABLE);
+    torn = button_subscriber_commit(&sub, n);
+    CHECK(recs && torn == (n < 2 ? n : 2) && sub.overruns == 3 + (uint32_t)torn,
+          "subscriber: %d torn of %d, %u overruns", torn, n, sub.overruns);
+
+    mb_sim_release(0, SETTLE_TICKS);
+}
+#endif
+
+/**
+  * @brief  仿真吞吐量：单个按键连续按下、松开
+  * @param  None
+  * @retval None
+  */
+static void throughput(void)
+{
+    const uint32_t rounds = 20000;
+    uint32_t ticks;
+    double t0, dt;
+
+    mb_sim_reset();
+    mb_sim_add(0, 1);
+    mb_sim_capture(0);
+
+    t0 = now_s();
+    for (uint32_t i = 0; i < rounds; i++) {
+        mb_sim_click(0, (i % 300) + 1, (i % 90) + 1);
+    }
+    dt = now_s() - t0;
+    ticks = mb_sim_now();
+
+    printf("Throughput: %u ticks in %.3f s (%.1f M ticks/s)\n", ticks, dt, ticks / dt / 1e6);
+}
+
+int main(void)
+{
+#if BUTTON_LAYOUT_SPLIT && BUTTON_SPLIT_DEFAULT_SLOTS
+    sweep_split_builtin();
+#endif
+    sweep_press_length();
+    sweep_click_gap();
+    sweep_bounce();
+#if BUTTON_ENABLE_ENCODER
+    sweep_encoder();
+#endif
+#if BUTTON_ENABLE_SWITCH
+    sweep_switch();
+#endif
+#if BUTTON_ENABLE_LOGIC
+    sweep_logic();
+#endif
+#if BUTTON_ENABLE_CALLBACKS
+    sweep_deferred();
+#endif
+#if BUTTON_ENABLE_POOL && BUTTON_ENABLE_CALLBACKS
+    sweep_pool();
+#endif
+#if !BUTTON_ENABLE_CONCURRENT
+    sweep_batch();
+#endif
+#if BUTTON_LAYOUT_SPLIT && BUTTON_ENABLE_CALLBACKS && !BUTTON_ENABLE_CONCURRENT
+    sweep_split_full();
+#endif
+#if BUTTON_ENABLE_TWO_PHASE && BUTTON_ENABLE_CALLBACKS
+    sweep_snapshot();
+    sweep_sampler();
+#if BUTTON_ENABLE_ENCODER && BUTTON_ENABLE_SWITCH
+    sweep_aux_snapshot();
+#endif
+#endif
+#if defined(__linux__)
+    sweep_hot_stores();
+#endif
+#if BUTTON_ENABLE_MMIO && BUTTON_ENABLE_COMPACT && defined(__linux__)
+    sweep_mmio_loads();
+#endif
+#if BUTTON_ENABLE_BUDGET_SCAN
+    sweep_budget();
+#endif
+#if BUTTON_EVENT_RING_SIZE
+    sweep_ring();
+    sweep_subscriber();
+#endif
+    throughput();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("Simulation sweep passed\n");
+    return 0;
+}